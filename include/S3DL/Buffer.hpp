@@ -1,36 +1,73 @@
 #pragma once
 
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
 #include <vulkan/vulkan.h>
 
 #include <S3DL/types.hpp>
+#include <S3DL/MemoryAllocator.hpp>
+#include <S3DL/MemoryDefragmenter.hpp>
+#include <S3DL/Readback.hpp>
 
 namespace s3dl
 {
-    class Buffer
+    class Buffer: public MemoryResource
     {
         public:
 
-            Buffer(uint64_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+            Buffer(uint64_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool persistentMapping = false);
+            Buffer(uint64_t size, VkBufferUsageFlags usage, MemoryUsage memoryUsage, bool persistentMapping = false);
             Buffer(const Buffer& buffer) = delete;
 
             Buffer& operator=(const Buffer& buffer) = delete;
 
-            void setData(const void* data, uint64_t size, uint64_t offset = 0);
+            void setData(const void* data, uint64_t size, uint64_t offset = 0, TransferBatch* batch = nullptr);
+            void fillFromBuffer(const Buffer& buffer, uint64_t size, uint64_t srcOffset = 0, uint64_t dstOffset = 0, TransferBatch* batch = nullptr);
             std::vector<uint8_t> getData() const;
+            void getData(void* data, uint64_t size, uint64_t offset = 0) const;
+            ReadbackHandle getDataAsync(RenderTarget& target, uint64_t size, uint64_t offset = 0) const;
+            ReadbackHandle getDataAsync(TransferBatch& batch, uint64_t size, uint64_t offset = 0) const;
+
+            template<typename T = uint8_t>
+            T* getMappedData(uint64_t offset = 0) const;
+            void flush(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) const;
+            void invalidate(uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE) const;
+            bool isHostCoherent() const;
+            bool isPersistentlyMapped() const;
 
+            void setRelocatable(bool relocatable);
+            bool isRelocatable() const;
+
+            uint64_t getSize() const;
+            VkMemoryPropertyFlags getMemoryProperties() const;
             VkBuffer getVulkanBuffer() const;
             
             ~Buffer();
 
         private:
 
-            uint32_t findSuitableMemory(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+            void relocate(VkCommandBuffer commandBuffer, RetiredResource& retiredResource);
+            ReadbackHandle recordReadback(VkCommandBuffer commandBuffer, uint64_t size, uint64_t offset) const;
+
+            void create(VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties, bool persistentMapping);
+
+            MemoryCategory getMemoryCategory() const;
+            bool isHostVisible() const;
 
             uint64_t _size;
             VkBufferUsageFlags _usage;
             VkMemoryPropertyFlags _properties;
 
             VkBuffer _buffer;
-            VkDeviceMemory _deviceMemory;
+            MemoryAllocation _memory;
+            uint8_t* _mappedData;
+            bool _relocatable;
+
+        friend UploadManager;
     };
 }
+
+#include <S3DL/BufferT.hpp>
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <S3DL/types.hpp>
+#include <S3DL/Buffer.hpp>
+
+namespace s3dl
+{
+    template<typename T>
+    T* Buffer::getMappedData(uint64_t offset) const
+    {
+        if (_mappedData == nullptr)
+            throw std::runtime_error("Cannot access mapped data of a buffer that is not persistently mapped.");
+
+        if (offset + sizeof(T) > _size)
+            throw std::runtime_error("Cannot access mapped data at offset " + std::to_string(offset) + " bytes in buffer of size " + std::to_string(_size) + " bytes.");
+
+        return reinterpret_cast<T*>(_mappedData + offset);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    class CompressedTextureData
+    {
+        public:
+
+            static bool isFormatSupported(VkFormat format);
+            static bool isFormatDecodable(VkFormat format);
+
+            CompressedTextureData(const std::string& filename);
+            CompressedTextureData(const CompressedTextureData& textureData) = default;
+
+            CompressedTextureData& operator=(const CompressedTextureData& textureData) = default;
+
+            VkFormat getFormat() const;
+            VkFormat getDecodedFormat() const;
+            const uvec2& getSize() const;
+            uvec2 getLevelSize(uint32_t level) const;
+            uint32_t getLayerCount() const;
+            uint32_t getMipLevels() const;
+
+            uint64_t getRawSize(uint32_t level) const;
+            const uint8_t* getRawData(uint32_t level, uint32_t layer) const;
+
+            TextureData decode(uint32_t level, uint32_t layer) const;
+
+        private:
+
+            static uint32_t getBlockSize(VkFormat format);
+            static bool isSrgb(VkFormat format);
+
+            static void decodeBc1Block(const uint8_t* block, uint8_t* texels, bool punchThrough);
+            static void decodeBc4Block(const uint8_t* block, uint8_t* texels, uint32_t channel);
+            static void decodeEtc2Block(const uint8_t* block, uint8_t* texels);
+            static void decodeEacBlock(const uint8_t* block, uint8_t* texels, uint32_t channel);
+
+            void loadDds();
+            void loadKtx2();
+
+            VkFormat _format;
+            uvec2 _size;
+            uint32_t _layerCount;
+            uint32_t _mipLevels;
+
+            std::vector<uint8_t> _data;
+            std::vector<uint64_t> _offsets;
+    };
+}
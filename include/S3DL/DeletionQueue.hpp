@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/MemoryAllocator.hpp>
+
+namespace s3dl
+{
+    struct RetiredResource
+    {
+        VkBuffer buffer;
+        VkBufferView bufferView;
+        VkImage image;
+        std::vector<VkImageView> imageViews;
+        VkSampler sampler;
+        MemoryAllocation allocation;
+        uint64_t submission;
+    };
+
+    class DeletionQueue
+    {
+        public:
+
+            DeletionQueue();
+            DeletionQueue(const DeletionQueue& queue) = delete;
+
+            DeletionQueue& operator=(const DeletionQueue& queue) = delete;
+
+            void enqueue(const RetiredResource& resource);
+            void collect();
+            void flush();
+
+            uint32_t getPendingCount() const;
+
+            ~DeletionQueue();
+
+        private:
+
+            static void destroy(const RetiredResource& resource);
+
+            void addSwapchain(const Swapchain& swapchain);
+            void removeSwapchain(const Swapchain& swapchain);
+            uint64_t beginSubmission();
+
+            uint64_t _submissionCount;
+            std::vector<const Swapchain*> _swapchains;
+            std::deque<RetiredResource> _resources;
+
+            mutable std::mutex _mutex;
+
+        friend Swapchain;
+    };
+}
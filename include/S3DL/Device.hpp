@@ -2,6 +2,9 @@
 
 #include <set>
 #include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
 #include <string>
 #include <stdexcept>
 #include <iostream>
@@ -42,6 +45,13 @@ namespace s3dl
             VkPhysicalDevice _handle;
     };
 
+    struct ThreadCommandPool
+    {
+        VkCommandPool commandPool;
+        std::vector<VkCommandBuffer> freeCommandBuffers;
+        std::mutex freeCommandBuffersMutex;
+    };
+
     class Device
     {
         public:
@@ -63,18 +73,56 @@ namespace s3dl
             VkDevice getVulkanDevice() const;
             VkQueue getVulkanGraphicsQueue() const;
             VkQueue getVulkanPresentQueue() const;
+            VkQueue getVulkanTransferQueue() const;
+            uint32_t getGraphicsQueueFamily() const;
+            uint32_t getTransferQueueFamily() const;
             VkCommandPool getVulkanCommandPool() const;
 
+            VkCommandBuffer acquireTransientCommandBuffer() const;
+            void releaseTransientCommandBuffer(VkCommandBuffer commandBuffer, std::thread::id owner = std::this_thread::get_id()) const;
+            void releaseThreadResources() const;
+
+            VkResult submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence) const;
+            VkResult present(const VkPresentInfoKHR& presentInfo) const;
+
+            MemoryAllocator* getMemoryAllocator() const;
+            StagingBufferPool* getStagingBufferPool() const;
+            SyncObjectPool* getSyncObjectPool() const;
+            DeletionQueue* getDeletionQueue() const;
+            UploadManager* getUploadManager() const;
+            UploadScheduler* getUploadScheduler() const;
+            SamplerCache* getSamplerCache() const;
+            ImageViewCache* getImageViewCache() const;
+            TextureStreamer* getTextureStreamer() const;
+
             ~Device();
 
         private:
 
             void create(const RenderTarget& target, const PhysicalDevice& physicalDevice, const std::set<std::string>& additionalExtensions);
+            ThreadCommandPool& getThreadCommandPool() const;
 
             PhysicalDevice _physicalDevice;
             VkDevice _device;
             VkQueue _graphicsQueue;
             VkQueue _presentQueue;
+            VkQueue _transferQueue;
+            uint32_t _graphicsQueueFamily;
+            uint32_t _transferQueueFamily;
             VkCommandPool _commandPool;
+
+            mutable std::unordered_map<std::thread::id, ThreadCommandPool> _threadCommandPools;
+            mutable std::mutex _threadCommandPoolsMutex;
+            mutable std::mutex _queueMutex;
+
+            MemoryAllocator* _memoryAllocator;
+            StagingBufferPool* _stagingBufferPool;
+            SyncObjectPool* _syncObjectPool;
+            DeletionQueue* _deletionQueue;
+            UploadManager* _uploadManager;
+            UploadScheduler* _uploadScheduler;
+            SamplerCache* _samplerCache;
+            ImageViewCache* _imageViewCache;
+            TextureStreamer* _textureStreamer;
     };
 }
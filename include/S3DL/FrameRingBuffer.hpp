@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    struct FrameRingAllocation
+    {
+        VkBuffer buffer;
+        uint64_t offset;
+        uint64_t size;
+        void* data;
+    };
+
+    class FrameRingBuffer
+    {
+        public:
+
+            FrameRingBuffer(const Swapchain& swapchain, uint64_t frameSize, VkBufferUsageFlags usage);
+            FrameRingBuffer(const FrameRingBuffer& ringBuffer) = delete;
+
+            FrameRingBuffer& operator=(const FrameRingBuffer& ringBuffer) = delete;
+
+            FrameRingAllocation allocate(uint64_t size, uint64_t alignment = 0);
+            template<typename T>
+            FrameRingAllocation push(const T& value);
+            template<typename T>
+            FrameRingAllocation pushArray(const T* values, uint32_t count);
+
+            uint64_t getFrameSize() const;
+            uint64_t getUsedSize() const;
+            VkBuffer getVulkanBuffer() const;
+
+            ~FrameRingBuffer();
+
+        private:
+
+            void reclaimRegion();
+
+            const Swapchain& _swapchain;
+
+            uint64_t _frameSize;
+            uint64_t _alignment;
+            Buffer* _buffer;
+
+            uint32_t _region;
+            uint64_t _head;
+            uint64_t _frame;
+    };
+}
+
+#include <S3DL/FrameRingBufferT.hpp>
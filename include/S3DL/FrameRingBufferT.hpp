@@ -0,0 +1,22 @@
+#pragma once
+
+#include <S3DL/types.hpp>
+#include <S3DL/FrameRingBuffer.hpp>
+
+namespace s3dl
+{
+    template<typename T>
+    FrameRingAllocation FrameRingBuffer::push(const T& value)
+    {
+        return pushArray(&value, 1);
+    }
+
+    template<typename T>
+    FrameRingAllocation FrameRingBuffer::pushArray(const T* values, uint32_t count)
+    {
+        FrameRingAllocation allocation = allocate(sizeof(T) * count);
+        std::memcpy(allocation.data, values, allocation.size);
+
+        return allocation;
+    }
+}
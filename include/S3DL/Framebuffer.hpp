@@ -1,8 +1,11 @@
 #pragma once
 
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
 #include <S3DL/types.hpp>
+#include <S3DL/Texture.hpp>
 
 namespace s3dl
 {
@@ -31,5 +34,8 @@ namespace s3dl
             std::vector<Texture*> _attachments;
             std::vector<bool> _attachmentsBelonging;
             std::vector<std::vector<VkImageView>> _vulkanAttachments;
+            std::vector<ImageViewPinHandle> _attachmentPins;
+
+        friend RenderTarget;
     };
 }
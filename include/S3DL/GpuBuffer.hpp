@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/Buffer.hpp>
+
+namespace s3dl
+{
+    template<typename T>
+    class GpuBuffer
+    {
+        public:
+
+            GpuBuffer(uint32_t count, VkBufferUsageFlags usage, MemoryUsage memoryUsage = MemoryUsage::GpuOnly);
+            GpuBuffer(const GpuBuffer<T>& buffer) = delete;
+
+            GpuBuffer<T>& operator=(const GpuBuffer<T>& buffer) = delete;
+
+            void set(uint32_t index, const T& value);
+            void set(const T* values, uint32_t count, uint32_t startIndex = 0);
+            T get(uint32_t index) const;
+            void get(T* values, uint32_t count, uint32_t startIndex = 0) const;
+            std::vector<T> get() const;
+
+            uint32_t getCount() const;
+            const Buffer& getBuffer() const;
+            VkBuffer getVulkanBuffer() const;
+
+        protected:
+
+            void checkRange(uint32_t count, uint32_t startIndex) const;
+
+            Buffer _buffer;
+            uint32_t _count;
+    };
+
+    template<typename T>
+    class StorageBuffer : public GpuBuffer<T>
+    {
+        public:
+
+            StorageBuffer(uint32_t count, MemoryUsage memoryUsage = MemoryUsage::GpuOnly);
+    };
+
+    template<typename T = VkDrawIndexedIndirectCommand>
+    class IndirectBuffer : public GpuBuffer<T>
+    {
+        public:
+
+            IndirectBuffer(uint32_t count, MemoryUsage memoryUsage = MemoryUsage::GpuOnly);
+    };
+
+    template<typename T>
+    class TexelBuffer : public GpuBuffer<T>
+    {
+        public:
+
+            TexelBuffer(uint32_t count, VkFormat format, MemoryUsage memoryUsage = MemoryUsage::GpuOnly);
+
+            VkFormat getFormat() const;
+            VkBufferView getVulkanBufferView() const;
+
+            ~TexelBuffer();
+
+        private:
+
+            VkFormat _format;
+            VkBufferView _bufferView;
+    };
+}
+
+#include <S3DL/GpuBufferT.hpp>
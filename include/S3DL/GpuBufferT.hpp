@@ -0,0 +1,134 @@
+#pragma once
+
+#include <S3DL/types.hpp>
+#include <S3DL/GpuBuffer.hpp>
+
+namespace s3dl
+{
+    template<typename T>
+    GpuBuffer<T>::GpuBuffer(uint32_t count, VkBufferUsageFlags usage, MemoryUsage memoryUsage) :
+        _buffer(sizeof(T) * count, usage, memoryUsage),
+        _count(count)
+    {
+    }
+
+    template<typename T>
+    void GpuBuffer<T>::set(uint32_t index, const T& value)
+    {
+        set(&value, 1, index);
+    }
+
+    template<typename T>
+    void GpuBuffer<T>::set(const T* values, uint32_t count, uint32_t startIndex)
+    {
+        checkRange(count, startIndex);
+        _buffer.setData(values, sizeof(T) * count, sizeof(T) * startIndex);
+    }
+
+    template<typename T>
+    T GpuBuffer<T>::get(uint32_t index) const
+    {
+        T value;
+        get(&value, 1, index);
+
+        return value;
+    }
+
+    template<typename T>
+    void GpuBuffer<T>::get(T* values, uint32_t count, uint32_t startIndex) const
+    {
+        checkRange(count, startIndex);
+        _buffer.getData(values, sizeof(T) * count, sizeof(T) * startIndex);
+    }
+
+    template<typename T>
+    std::vector<T> GpuBuffer<T>::get() const
+    {
+        std::vector<T> values(_count);
+        get(values.data(), _count);
+
+        return values;
+    }
+
+    template<typename T>
+    uint32_t GpuBuffer<T>::getCount() const
+    {
+        return _count;
+    }
+
+    template<typename T>
+    const Buffer& GpuBuffer<T>::getBuffer() const
+    {
+        return _buffer;
+    }
+
+    template<typename T>
+    VkBuffer GpuBuffer<T>::getVulkanBuffer() const
+    {
+        return _buffer.getVulkanBuffer();
+    }
+
+    template<typename T>
+    void GpuBuffer<T>::checkRange(uint32_t count, uint32_t startIndex) const
+    {
+        if (static_cast<uint64_t>(startIndex) + count > _count)
+            throw std::runtime_error("Cannot access elements " + std::to_string(startIndex) + " to " + std::to_string(static_cast<uint64_t>(startIndex) + count) + " of a GPU buffer of " + std::to_string(_count) + " elements.");
+    }
+
+    template<typename T>
+    StorageBuffer<T>::StorageBuffer(uint32_t count, MemoryUsage memoryUsage) :
+        GpuBuffer<T>(count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryUsage)
+    {
+    }
+
+    template<typename T>
+    IndirectBuffer<T>::IndirectBuffer(uint32_t count, MemoryUsage memoryUsage) :
+        GpuBuffer<T>(count, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryUsage)
+    {
+    }
+
+    template<typename T>
+    TexelBuffer<T>::TexelBuffer(uint32_t count, VkFormat format, MemoryUsage memoryUsage) :
+        GpuBuffer<T>(count, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT, memoryUsage),
+        _format(format),
+        _bufferView(VK_NULL_HANDLE)
+    {
+        // The view would dangle if the defragmenter moved the buffer
+
+        this->_buffer.setRelocatable(false);
+
+        VkBufferViewCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
+        createInfo.buffer = this->_buffer.getVulkanBuffer();
+        createInfo.format = _format;
+        createInfo.offset = 0;
+        createInfo.range = VK_WHOLE_SIZE;
+
+        VkResult result = vkCreateBufferView(Device::Active->getVulkanDevice(), &createInfo, nullptr, &_bufferView);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create buffer view. VkResult: " + std::to_string(result));
+    }
+
+    template<typename T>
+    VkFormat TexelBuffer<T>::getFormat() const
+    {
+        return _format;
+    }
+
+    template<typename T>
+    VkBufferView TexelBuffer<T>::getVulkanBufferView() const
+    {
+        return _bufferView;
+    }
+
+    template<typename T>
+    TexelBuffer<T>::~TexelBuffer()
+    {
+        if (_bufferView != VK_NULL_HANDLE)
+        {
+            RetiredResource retiredResource{};
+            retiredResource.bufferView = _bufferView;
+            Device::Active->getDeletionQueue()->enqueue(retiredResource);
+        }
+    }
+}
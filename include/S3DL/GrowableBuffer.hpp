@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    class GrowableBuffer
+    {
+        public:
+
+            static const uint64_t MIN_CAPACITY = 256;
+
+            GrowableBuffer(VkBufferUsageFlags usage, MemoryUsage memoryUsage, uint64_t capacity = MIN_CAPACITY);
+            GrowableBuffer(const GrowableBuffer& buffer) = delete;
+
+            GrowableBuffer& operator=(const GrowableBuffer& buffer) = delete;
+
+            uint64_t append(const void* data, uint64_t size, TransferBatch* batch = nullptr);
+            void setData(const void* data, uint64_t size, uint64_t offset = 0, TransferBatch* batch = nullptr);
+            void getData(void* data, uint64_t size, uint64_t offset = 0) const;
+
+            void reserve(uint64_t capacity, TransferBatch* batch = nullptr);
+            void resize(uint64_t size, TransferBatch* batch = nullptr);
+            void clear();
+
+            uint64_t getSize() const;
+            uint64_t getCapacity() const;
+            const Buffer& getBuffer() const;
+            VkBuffer getVulkanBuffer() const;
+
+            ~GrowableBuffer();
+
+        private:
+
+            void write(const void* data, uint64_t size, uint64_t offset, TransferBatch* batch);
+
+            VkBufferUsageFlags _usage;
+            MemoryUsage _memoryUsage;
+
+            Buffer* _buffer;
+            uint64_t _size;
+
+            TransferBatch* _pendingCopyBatch;
+    };
+}
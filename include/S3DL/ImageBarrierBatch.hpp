@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    class ImageBarrierBatch
+    {
+        public:
+
+            static void getLayoutAccess(VkImageLayout layout, bool source, VkPipelineStageFlags& stage, VkAccessFlags& access);
+
+            ImageBarrierBatch();
+            ImageBarrierBatch(const ImageBarrierBatch& barriers) = delete;
+
+            ImageBarrierBatch& operator=(const ImageBarrierBatch& barriers) = delete;
+
+            void addTransition(VkImage image, const VkImageSubresourceRange& range, VkImageLayout oldLayout, VkImageLayout newLayout);
+
+            bool isEmpty() const;
+            uint32_t getBarrierCount() const;
+
+            void record(VkCommandBuffer commandBuffer);
+            void record(const Swapchain& swapchain);
+            void submit();
+
+            ~ImageBarrierBatch();
+
+        private:
+
+            std::vector<VkImageMemoryBarrier> _barriers;
+            VkPipelineStageFlags _srcStageMask;
+            VkPipelineStageFlags _dstStageMask;
+    };
+}
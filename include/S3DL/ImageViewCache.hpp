@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/Texture.hpp>
+
+namespace s3dl
+{
+    struct ImageViewPin
+    {
+    };
+
+    struct ImageViewCacheStatistics
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint32_t liveViews;
+        uint32_t pinnedViews;
+    };
+
+    class ImageViewCache
+    {
+        public:
+
+            static const uint32_t SHARD_COUNT = 16;
+            static const uint32_t DEFAULT_CAPACITY = 4096;
+
+            ImageViewCache(uint32_t capacity = DEFAULT_CAPACITY);
+            ImageViewCache(const ImageViewCache& cache) = delete;
+
+            ImageViewCache& operator=(const ImageViewCache& cache) = delete;
+
+            VkImageView getView(VkImage image, VkFormat format, const TextureViewParameters& viewParameters);
+            ImageViewPinHandle pinView(VkImage image, const TextureViewParameters& viewParameters);
+            void prewarm(VkImage image, VkFormat format, const std::vector<TextureViewParameters>& viewParameters);
+
+            void moveImage(VkImage oldImage, VkImage newImage, std::vector<VkImageView>& retiredViews);
+            void releaseImage(VkImage image, std::vector<VkImageView>& retiredViews);
+
+            void setCapacity(uint32_t capacity);
+            void evict();
+
+            ImageViewCacheStatistics getStatistics() const;
+
+            ~ImageViewCache();
+
+        private:
+
+            struct Key
+            {
+                VkImage image;
+                TextureViewParameters viewParameters;
+            };
+
+            struct KeyHasher
+            {
+                size_t operator()(const Key& x) const;
+            };
+
+            struct KeyComparator
+            {
+                bool operator()(const Key& x, const Key& y) const;
+            };
+
+            struct Entry
+            {
+                VkImageView view;
+                ImageViewPinHandle pin;
+                uint64_t lastUse;
+            };
+
+            struct Shard
+            {
+                std::unordered_map<Key, Entry, KeyHasher, KeyComparator> entries;
+                mutable std::mutex mutex;
+            };
+
+            static VkImageView createView(VkImage image, VkFormat format, const TextureViewParameters& viewParameters);
+
+            Shard& getShard(VkImage image);
+            Entry& getEntry(Shard& shard, const Key& key);
+
+            std::array<Shard, SHARD_COUNT> _shards;
+
+            std::atomic<uint32_t> _capacity;
+            std::atomic<uint64_t> _clock;
+            std::atomic<uint64_t> _hits;
+            std::atomic<uint64_t> _misses;
+            std::atomic<uint64_t> _evictions;
+            std::atomic<uint32_t> _liveViews;
+    };
+}
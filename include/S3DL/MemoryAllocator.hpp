@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <array>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    enum class MemoryUsage
+    {
+        GpuOnly,
+        Upload,
+        Readback,
+        Dynamic
+    };
+
+    enum class MemoryCategory
+    {
+        Other,
+        Mesh,
+        Uniform,
+        Texture,
+        Attachment,
+        Staging
+    };
+
+    static const uint32_t MEMORY_CATEGORY_COUNT = 6;
+
+    struct MemoryBlock
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize size;
+        uint32_t memoryType;
+        bool dedicated;
+
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+        uint32_t allocationCount;
+        VkDeviceSize bytesInUse;
+
+        void* mapped;
+        uint32_t mapCount;
+
+        std::map<VkDeviceSize, MemoryResource*> resources;
+        bool evacuating;
+    };
+
+    struct MemoryAllocation
+    {
+        MemoryBlock* block;
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint32_t memoryType;
+        MemoryCategory category;
+    };
+
+    struct MemoryStatistics
+    {
+        uint32_t blockCount;
+        uint32_t dedicatedBlockCount;
+        uint32_t allocationCount;
+        VkDeviceSize bytesReserved;
+        VkDeviceSize bytesInUse;
+        VkDeviceSize largestFreeRange;
+        float fragmentation;
+    };
+
+    struct MemoryCategoryUsage
+    {
+        VkDeviceSize bytes;
+        VkDeviceSize peakBytes;
+        uint32_t allocationCount;
+    };
+
+    struct MemoryHeapBudget
+    {
+        VkDeviceSize heapSize;
+        VkDeviceSize budget;
+        VkDeviceSize usage;
+
+        VkDeviceSize blockBytes;
+        VkDeviceSize allocatedBytes;
+        VkDeviceSize peakAllocatedBytes;
+        uint32_t allocationCount;
+
+        std::array<MemoryCategoryUsage, MEMORY_CATEGORY_COUNT> categories;
+    };
+
+    class MemoryAllocator
+    {
+        public:
+
+            static const VkDeviceSize BLOCK_SIZE = 64 * 1024 * 1024;
+
+            MemoryAllocator(const PhysicalDevice& physicalDevice, VkDevice device, bool memoryBudgetSupported);
+            MemoryAllocator(const MemoryAllocator& allocator) = delete;
+
+            MemoryAllocator& operator=(const MemoryAllocator& allocator) = delete;
+
+            static void getMemoryUsageFlags(MemoryUsage usage, VkMemoryPropertyFlags& requiredFlags, VkMemoryPropertyFlags& preferredFlags);
+            static bool requiresDedicatedBlock(VkDeviceSize size, VkDeviceSize blockSize);
+            static bool allocateFromBlock(MemoryBlock* block, const VkMemoryRequirements& requirements, MemoryAllocation& allocation);
+            static void freeFromBlock(MemoryBlock* block, const MemoryAllocation& allocation);
+
+            uint32_t findMemoryType(uint32_t typeFilter, MemoryUsage usage) const;
+            uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags = 0) const;
+            VkMemoryPropertyFlags getMemoryTypeFlags(uint32_t memoryType) const;
+
+            MemoryAllocation allocate(const VkMemoryRequirements& memoryRequirements, uint32_t memoryType, bool linear, MemoryCategory category = MemoryCategory::Other, MemoryResource* resource = nullptr);
+            void free(const MemoryAllocation& allocation);
+            void detachResource(const MemoryAllocation& allocation);
+
+            void* map(const MemoryAllocation& allocation);
+            void unmap(const MemoryAllocation& allocation);
+            void flush(const MemoryAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+            void invalidate(const MemoryAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+            MemoryStatistics getStatistics() const;
+            MemoryStatistics getStatistics(uint32_t memoryType) const;
+
+            bool isMemoryBudgetSupported() const;
+            MemoryHeapBudget getHeapBudget(uint32_t heapIndex) const;
+            std::vector<MemoryHeapBudget> getHeapBudgets() const;
+
+            uint64_t getRelocationCount() const;
+
+            ~MemoryAllocator();
+
+        private:
+
+            uint32_t getPoolIndex(uint32_t memoryType, bool linear) const;
+            VkDeviceSize getBlockSize(uint32_t memoryType) const;
+            bool isNonCoherent(uint32_t memoryType) const;
+            VkMappedMemoryRange getMappedRange(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+            MemoryBlock* createBlock(uint32_t memoryType, VkDeviceSize size, bool dedicated);
+            void destroyBlock(MemoryBlock* block);
+
+            static uint32_t countBits(uint32_t value);
+            static void accumulateStatistics(const MemoryBlock* block, MemoryStatistics& statistics, VkDeviceSize& freeBytes);
+
+            void trackAllocation(const MemoryAllocation& allocation);
+            void trackFree(const MemoryAllocation& allocation);
+
+            VkPhysicalDevice _physicalDevice;
+            VkDevice _device;
+            VkPhysicalDeviceMemoryProperties _memoryProperties;
+            VkDeviceSize _bufferImageGranularity;
+            VkDeviceSize _nonCoherentAtomSize;
+
+            std::vector<std::vector<MemoryBlock*>> _pools;
+
+            bool _memoryBudgetSupported;
+            std::vector<MemoryHeapBudget> _heapBudgets;
+
+            uint64_t _relocationCount;
+
+            mutable std::recursive_mutex _mutex;
+
+        friend MemoryDefragmenter;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/MemoryAllocator.hpp>
+
+namespace s3dl
+{
+    class MemoryResource
+    {
+        public:
+
+            virtual bool isRelocatable() const = 0;
+
+            virtual ~MemoryResource() = default;
+
+        protected:
+
+            virtual void relocate(VkCommandBuffer commandBuffer, RetiredResource& retiredResource) = 0;
+
+        friend MemoryDefragmenter;
+    };
+
+    struct DefragmentationStatistics
+    {
+        uint32_t allocationsMoved;
+        VkDeviceSize bytesMoved;
+        uint32_t blocksReleased;
+        VkDeviceSize bytesReleased;
+    };
+
+    class MemoryDefragmenter
+    {
+        public:
+
+            static const VkDeviceSize DEFAULT_BYTES_PER_PASS = 16 * 1024 * 1024;
+
+            MemoryDefragmenter(const Swapchain& swapchain, VkDeviceSize bytesPerPass = DEFAULT_BYTES_PER_PASS);
+            MemoryDefragmenter(const MemoryDefragmenter& defragmenter) = delete;
+
+            MemoryDefragmenter& operator=(const MemoryDefragmenter& defragmenter) = delete;
+
+            DefragmentationStatistics defragment();
+
+            void setBytesPerPass(VkDeviceSize bytesPerPass);
+            VkDeviceSize getBytesPerPass() const;
+            const DefragmentationStatistics& getTotalStatistics() const;
+
+        private:
+
+            MemoryBlock* findEvacuationCandidate() const;
+
+            const Swapchain& _swapchain;
+            VkDeviceSize _bytesPerPass;
+
+            DefragmentationStatistics _totalStatistics;
+    };
+}
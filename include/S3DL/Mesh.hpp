@@ -20,12 +20,14 @@ namespace s3dl
 
             Mesh& operator=(const Mesh& mesh) = delete;
 
+            void upload(TransferBatch* batch = nullptr) const;
+
             ~Mesh();
 
         private:
 
-            void createVertexBuffer() const;
-            void createIndexBuffer() const;
+            void createVertexBuffer(TransferBatch* batch) const;
+            void createIndexBuffer(TransferBatch* batch) const;
             void destroyVertexBuffer() const;
             void destroyIndexBuffer() const;
 
@@ -37,22 +37,42 @@ namespace s3dl
     }
 
     template<typename T>
-    void Mesh<T>::createVertexBuffer() const
+    void Mesh<T>::upload(TransferBatch* batch) const
+    {
+        // Upload both buffers in a single submit when no batch is given
+
+        if (batch == nullptr)
+        {
+            TransferBatch localBatch;
+            upload(&localBatch);
+            localBatch.submit();
+            return;
+        }
+
+        if (!_vertexBufferCreated)
+            createVertexBuffer(batch);
+
+        if (!_indexBufferCreated)
+            createIndexBuffer(batch);
+    }
+
+    template<typename T>
+    void Mesh<T>::createVertexBuffer(TransferBatch* batch) const
     {
         destroyVertexBuffer();
 
-        _vertexBuffer = new Buffer(_vertices.size() * sizeof(T), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        _vertexBuffer->setData(_vertices.data(), _vertices.size() * sizeof(T));
+        _vertexBuffer = new Buffer(_vertices.size() * sizeof(T), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, MemoryUsage::GpuOnly);
+        _vertexBuffer->setData(_vertices.data(), _vertices.size() * sizeof(T), 0, batch);
         _vertexBufferCreated = true;
     }
 
     template<typename T>
-    void Mesh<T>::createIndexBuffer() const
+    void Mesh<T>::createIndexBuffer(TransferBatch* batch) const
     {
         destroyIndexBuffer();
 
-        _indexBuffer = new Buffer(_indices.size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        _indexBuffer->setData(_indices.data(), _indices.size() * sizeof(uint32_t));
+        _indexBuffer = new Buffer(_indices.size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, MemoryUsage::GpuOnly);
+        _indexBuffer->setData(_indices.data(), _indices.size() * sizeof(uint32_t), 0, batch);
         _indexBufferCreated = true;
     }
 
@@ -79,11 +99,8 @@ namespace s3dl
     template<typename T>
     void Mesh<T>::draw(VkCommandBuffer commandBuffer) const
     {
-        if (!_vertexBufferCreated)
-            createVertexBuffer();
-        
-        if (!_indexBufferCreated)
-            createIndexBuffer();
+        if (!_vertexBufferCreated || !_indexBufferCreated)
+            upload();
 
         VkDeviceSize offsets[] = { 0 };
         VkBuffer vertexBuffer = _vertexBuffer->getVulkanBuffer();
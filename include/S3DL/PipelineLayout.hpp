@@ -11,6 +11,7 @@
 #include <vulkan/vulkan.h>
 
 #include <S3DL/types.hpp>
+#include <S3DL/Texture.hpp>
 
 namespace s3dl
 {
@@ -21,6 +22,15 @@ namespace s3dl
         uint32_t offset;
     };
 
+    struct DescriptorResourceState
+    {
+        const Texture* texture;
+        const TextureArray* textureArray;
+        std::array<uint32_t, 2> layerRange;
+        const Buffer* buffer;
+        ImageViewPinHandle viewPin;
+    };
+
     class PipelineLayout
     {
         public:
@@ -32,10 +42,12 @@ namespace s3dl
             void declareGlobalUniformArray(uint32_t binding, uint32_t size, uint32_t count, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareGlobalUniformSampler(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareGlobalUniformSamplerArray(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
+            void declareGlobalStorageBuffer(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareDrawablesUniform(uint32_t binding, uint32_t size, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareDrawablesUniformArray(uint32_t binding, uint32_t size, uint32_t count, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareDrawablesUniformSampler(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
             void declareDrawablesUniformSamplerArray(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
+            void declareDrawablesStorageBuffer(uint32_t binding, VkShaderStageFlags shaderStage = VK_SHADER_STAGE_ALL_GRAPHICS);
 
             void lock(const Swapchain& swapchain);
             void unlock();
@@ -46,12 +58,18 @@ namespace s3dl
             void setGlobalUniformArray(uint32_t binding, const T* values, uint32_t count, uint32_t startIndex = 0);
             void setGlobalUniformSampler(uint32_t binding, const Texture& texture);
             void setGlobalUniformSamplerArray(uint32_t binding, const TextureArray& textureArray, std::array<uint32_t, 2> layerRange);
+            void setGlobalStorageBuffer(uint32_t binding, const Buffer& buffer, uint64_t offset = 0, uint64_t range = VK_WHOLE_SIZE);
+            template<typename T>
+            void setGlobalStorageBuffer(uint32_t binding, const GpuBuffer<T>& buffer);
             template<typename T>
             void setDrawablesUniform(const Drawable& drawable, uint32_t binding, const T& value);
             template<typename T>
             void setDrawablesUniformArray(const Drawable& drawable, uint32_t binding, const T* values, uint32_t count, uint32_t startIndex = 0);
             void setDrawablesUniformSampler(const Drawable& drawable, uint32_t binding, const Texture& texture);
             void setDrawablesUniformSamplerArray(const Drawable& drawable, uint32_t binding, const TextureArray& textureArray, std::array<uint32_t, 2> layerRange);
+            void setDrawablesStorageBuffer(const Drawable& drawable, uint32_t binding, const Buffer& buffer, uint64_t offset = 0, uint64_t range = VK_WHOLE_SIZE);
+            template<typename T>
+            void setDrawablesStorageBuffer(const Drawable& drawable, uint32_t binding, const GpuBuffer<T>& buffer);
 
             VkPipelineLayout getVulkanPipelineLayout() const;
 
@@ -93,6 +111,8 @@ namespace s3dl
 
             void addDrawable(const Drawable& drawable);
 
+            std::vector<bool> updateRelocatedResources(const std::vector<DescriptorResourceState>& resources, std::vector<std::pair<VkImageView, VkSampler>>& samplers, std::vector<VkDescriptorBufferInfo>& storageBuffers) const;
+
             static TextureViewParameters getDescriptorViewParameters(VkFormat format, std::array<uint32_t, 2> layerRange = {0, 1});
 
             std::vector<DescriptorSetLayoutBindingState> _globalBindings;
@@ -117,11 +137,19 @@ namespace s3dl
             uint32_t _alignment;
             std::vector<std::pair<VkImageView, VkSampler>> _globalSamplers;
             std::unordered_map<const Drawable*, std::vector<std::pair<VkImageView, VkSampler>>> _drawablesSamplers;
+            std::vector<VkDescriptorBufferInfo> _globalStorageBuffers;
+            std::unordered_map<const Drawable*, std::vector<VkDescriptorBufferInfo>> _drawablesStorageBuffers;
+            std::vector<DescriptorResourceState> _globalResources;
+            std::unordered_map<const Drawable*, std::vector<DescriptorResourceState>> _drawablesResources;
+            uint64_t _globalRelocationCount;
+            std::unordered_map<const Drawable*, uint64_t> _drawablesRelocationCount;
             
             std::vector<std::vector<bool>> _globalNeedsUpdate;
             std::vector<std::unordered_map<const Drawable*, std::vector<bool>>> _drawablesNeedsUpdate;
+            std::vector<bool> _globalDataNeedsUpload;
+            std::unordered_map<const Drawable*, std::vector<bool>> _drawablesDataNeedsUpload;
 
-            std::array<VkDescriptorPoolSize, 3> _descriptorPoolSizes;
+            std::array<VkDescriptorPoolSize, 4> _descriptorPoolSizes;
             VkDescriptorPoolCreateInfo _descriptorPool;
             VkDescriptorPool _vulkanDescriptorPool;
 
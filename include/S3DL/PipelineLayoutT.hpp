@@ -20,7 +20,16 @@ namespace s3dl
         memcpy(&_globalData[_globalBindings[binding].offset + _globalBindings[binding].size * startIndex], values, _globalBindings[binding].size * count);
 
         for (int i(0); i < _swapchainImageCount; i++)
+        {
             _globalNeedsUpdate[binding][i] = true;
+            _globalDataNeedsUpload[i] = true;
+        }
+    }
+
+    template<typename T>
+    void PipelineLayout::setGlobalStorageBuffer(uint32_t binding, const GpuBuffer<T>& buffer)
+    {
+        setGlobalStorageBuffer(binding, buffer.getBuffer());
     }
 
     template<typename T>
@@ -39,6 +48,15 @@ namespace s3dl
         memcpy(&_drawablesData[&drawable][_drawablesBindings[binding].offset + _drawablesBindings[binding].size * startIndex], values, _drawablesBindings[binding].size * count);
 
         for (int i(0); i < _swapchainImageCount; i++)
+        {
             _drawablesNeedsUpdate[binding][&drawable][i] = true;
+            _drawablesDataNeedsUpload[&drawable][i] = true;
+        }
+    }
+
+    template<typename T>
+    void PipelineLayout::setDrawablesStorageBuffer(const Drawable& drawable, uint32_t binding, const GpuBuffer<T>& buffer)
+    {
+        setDrawablesStorageBuffer(drawable, binding, buffer.getBuffer());
     }
 }
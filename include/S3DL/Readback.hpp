@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    class Readback
+    {
+        public:
+
+            Readback(const Readback& readback) = delete;
+
+            Readback& operator=(const Readback& readback) = delete;
+
+            bool isComplete() const;
+            void wait() const;
+
+            uint64_t getSize() const;
+            const void* getData() const;
+            TextureData getTextureData() const;
+
+            ~Readback();
+
+        private:
+
+            Readback(uint64_t size, const uvec2& imageSize);
+
+            void recordBarriers(VkCommandBuffer commandBuffer, bool before) const;
+
+            Buffer* _buffer;
+            uint64_t _size;
+            uvec2 _imageSize;
+
+            const Swapchain* _swapchain;
+            uint64_t _frame;
+
+            mutable bool _complete;
+            mutable bool _invalidated;
+
+        friend Buffer;
+        friend TextureArray;
+        friend TransferBatch;
+    };
+
+    typedef std::shared_ptr<Readback> ReadbackHandle;
+}
@@ -48,5 +48,6 @@ namespace s3dl
         
         friend Pipeline;
         friend Framebuffer;
+        friend RenderTarget;
     };
 }
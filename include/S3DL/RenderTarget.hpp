@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <cstdint>
 
 #include <vulkan/vulkan.h>
 
@@ -23,6 +25,9 @@ namespace s3dl
             void bindPipeline(const Pipeline* pipeline);
             void draw(const Drawable& drawable);
             void beginNextSubpass();
+            void setLayout(const TextureArray& textureArray, VkImageLayout layout, std::array<uint32_t, 2> layerRange = {0, VK_REMAINING_ARRAY_LAYERS}, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS});
+            void setLayout(const Texture& texture, VkImageLayout layout, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS});
+            void recordBarriers(ImageBarrierBatch& barriers);
             void display();
 
             const uvec2& getTargetSize() const;
@@ -44,5 +49,8 @@ namespace s3dl
             const RenderPass* _currentRenderPass;
             const Framebuffer* _currentFramebuffer;
             const Pipeline* _currentPipeline;
+
+        friend Buffer;
+        friend TextureArray;
     };
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <S3DL/RenderTexture.hpp>
 
 #include <S3DL/Device.hpp>
+#include <S3DL/MemoryAllocator.hpp>
+#include <S3DL/MemoryDefragmenter.hpp>
 
 #include <S3DL/Swapchain.hpp>
 
@@ -32,10 +34,26 @@
 // Classes for ressource management
 
 #include <S3DL/Buffer.hpp>
+#include <S3DL/FrameRingBuffer.hpp>
+#include <S3DL/StagingBufferPool.hpp>
+#include <S3DL/SyncObjectPool.hpp>
+#include <S3DL/DeletionQueue.hpp>
+#include <S3DL/UploadManager.hpp>
+#include <S3DL/UploadScheduler.hpp>
+#include <S3DL/TransferBatch.hpp>
+#include <S3DL/ImageBarrierBatch.hpp>
+#include <S3DL/Readback.hpp>
+#include <S3DL/GrowableBuffer.hpp>
+#include <S3DL/GpuBuffer.hpp>
 #include <S3DL/stb/stb_image.hpp>
 #include <S3DL/stb/stb_image_write.hpp>
 #include <S3DL/TextureData.hpp>
+#include <S3DL/CompressedTextureData.hpp>
 #include <S3DL/Texture.hpp>
+#include <S3DL/SamplerCache.hpp>
+#include <S3DL/ImageViewCache.hpp>
+#include <S3DL/TextureStreamer.hpp>
+#include <S3DL/TextureLoader.hpp>
 
 #include <S3DL/Framebuffer.hpp>
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/Texture.hpp>
+
+namespace s3dl
+{
+    class CachedSampler
+    {
+        public:
+
+            CachedSampler(const CachedSampler& sampler) = delete;
+
+            CachedSampler& operator=(const CachedSampler& sampler) = delete;
+
+            VkSampler getVulkanSampler() const;
+
+            ~CachedSampler();
+
+        private:
+
+            CachedSampler(const VkSamplerCreateInfo& createInfo);
+
+            VkSampler _vulkanSampler;
+
+        friend SamplerCache;
+    };
+
+    class SamplerCache
+    {
+        public:
+
+            SamplerCache();
+            SamplerCache(const SamplerCache& cache) = delete;
+
+            SamplerCache& operator=(const SamplerCache& cache) = delete;
+
+            SamplerHandle getSampler(const TextureSampler& sampler);
+
+            uint32_t getSamplerCount() const;
+            void collect();
+
+            void notifyReassignment();
+            uint64_t getReassignmentCount() const;
+
+            ~SamplerCache();
+
+        private:
+
+            std::unordered_map<TextureSampler, SamplerHandle, TextureSampler::Hasher, TextureSampler::Comparator> _samplers;
+
+            mutable std::mutex _mutex;
+
+            std::atomic<uint64_t> _reassignmentCount;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    struct StagingPoolStatistics
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint32_t bufferCount;
+        uint64_t bytesCached;
+    };
+
+    class StagingBufferPool
+    {
+        public:
+
+            static const uint64_t MIN_BUCKET_SIZE = 64 * 1024;
+            static const uint64_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+            StagingBufferPool(uint64_t capacity = DEFAULT_CAPACITY);
+            StagingBufferPool(const StagingBufferPool& pool) = delete;
+
+            StagingBufferPool& operator=(const StagingBufferPool& pool) = delete;
+
+            static uint64_t getBucketSize(uint64_t size);
+            static bool fitsInCache(uint64_t bucketSize, uint64_t bytesCached, uint64_t capacity);
+
+            Buffer* acquire(uint64_t size, MemoryUsage usage);
+            void release(Buffer* buffer);
+            void discard(Buffer* buffer);
+            void clear();
+
+            void setCapacity(uint64_t capacity);
+            uint64_t getCapacity() const;
+            StagingPoolStatistics getStatistics() const;
+
+            ~StagingBufferPool();
+
+        private:
+
+            void trim();
+
+            uint64_t _capacity;
+
+            std::map<uint64_t, std::vector<Buffer*>> _uploadBuffers;
+            std::map<uint64_t, std::vector<Buffer*>> _readbackBuffers;
+            std::unordered_map<const Buffer*, MemoryUsage> _acquiredBuffers;
+
+            StagingPoolStatistics _statistics;
+
+            mutable std::mutex _mutex;
+    };
+
+    class StagingBuffer
+    {
+        public:
+
+            StagingBuffer(uint64_t size, MemoryUsage usage);
+            explicit StagingBuffer(Buffer* buffer);
+            StagingBuffer(const StagingBuffer& stagingBuffer) = delete;
+
+            StagingBuffer& operator=(const StagingBuffer& stagingBuffer) = delete;
+
+            Buffer* operator->() const;
+            Buffer& operator*() const;
+            Buffer* get() const;
+            Buffer* detach();
+
+            ~StagingBuffer();
+
+        private:
+
+            Buffer* _buffer;
+    };
+}
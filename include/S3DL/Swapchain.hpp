@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 
 #include <vulkan/vulkan.h>
 
@@ -20,6 +22,9 @@ namespace s3dl
 
             uint32_t getCurrentImage() const;
             uint32_t getImageCount() const;
+            uint64_t getFrameCount() const;
+            uint64_t getCompletedFrameCount() const;
+            void waitFrame(uint64_t frame) const;
 
             VkCommandBuffer getCurrentCommandBuffer() const;
 
@@ -31,6 +36,7 @@ namespace s3dl
         private:
 
             void create(const RenderTarget& target);
+            uint64_t getCompletedSubmissionCount() const;
 
             void startRecordingCommandBuffer(unsigned int index) const;
             void stopRecordingCommandBuffer(unsigned int index) const;
@@ -50,11 +56,16 @@ namespace s3dl
 
             mutable VkFence _acquireFence;
             mutable std::vector<VkFence> _renderFences;
+            mutable std::vector<uint64_t> _renderFrames;
+            mutable std::vector<uint64_t> _renderSubmissions;
             mutable std::vector<VkSemaphore> _renderSemaphores;
 
             mutable std::vector<VkCommandBuffer> _commandBuffers;
             mutable unsigned int _currentImage;
+            mutable uint64_t _frameCount;
+            mutable uint64_t _submission;
 
         friend Framebuffer;
+        friend DeletionQueue;
     };
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    class SyncObjectPool
+    {
+        public:
+
+            SyncObjectPool();
+            SyncObjectPool(const SyncObjectPool& pool) = delete;
+
+            SyncObjectPool& operator=(const SyncObjectPool& pool) = delete;
+
+            VkFence acquireFence();
+            void releaseFence(VkFence fence);
+
+            VkSemaphore acquireSemaphore();
+            void releaseSemaphore(VkSemaphore semaphore);
+
+            ~SyncObjectPool();
+
+        private:
+
+            std::vector<VkFence> _fences;
+            std::vector<VkSemaphore> _semaphores;
+
+            std::mutex _mutex;
+    };
+}
@@ -1,15 +1,21 @@
 #pragma once
 
+#include <vector>
 #include <string>
 #include <cstring>
 #include <cstdint>
 #include <array>
+#include <memory>
+#include <algorithm>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 
 #include <vulkan/vulkan.h>
 
 #include <S3DL/types.hpp>
+#include <S3DL/Readback.hpp>
+#include <S3DL/MemoryAllocator.hpp>
+#include <S3DL/MemoryDefragmenter.hpp>
 
 namespace s3dl
 {
@@ -18,30 +24,42 @@ namespace s3dl
         public:
 
             TextureSampler();
-            TextureSampler(const TextureSampler& sampler) = delete;
+            TextureSampler(const TextureSampler& sampler) = default;
 
-            TextureSampler& operator=(const TextureSampler& sampler) = delete;
+            TextureSampler& operator=(const TextureSampler& sampler) = default;
 
-            VkSampler getVulkanSampler() const;
+            void setFilter(VkFilter magFilter, VkFilter minFilter, VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR);
+            void setAddressMode(VkSamplerAddressMode u, VkSamplerAddressMode v, VkSamplerAddressMode w = VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            void setBorderColor(VkBorderColor borderColor);
+            void setLodRange(float minLod, float maxLod = VK_LOD_CLAMP_NONE, float lodBias = 0.0f);
+            void setAnisotropy(float maxAnisotropy);
 
-            ~TextureSampler();
+            const VkSamplerCreateInfo& getVulkanSamplerCreateInfo() const;
 
-        private:
+            struct Hasher
+            {
+                size_t operator()(const TextureSampler& x) const;
+            };
+
+            struct Comparator
+            {
+                bool operator()(const TextureSampler& x, const TextureSampler& y) const;
+            };
 
-            void createVulkanSampler() const;
-            void destroyVulkanSampler() const;
+        private:
 
             VkSamplerCreateInfo _sampler;
-            mutable bool _vulkanSamplerComputed;
-            mutable VkSampler _vulkanSampler;
     };
 
+    typedef std::shared_ptr<const CachedSampler> SamplerHandle;
+    typedef std::shared_ptr<const ImageViewPin> ImageViewPinHandle;
+
     class TextureViewParameters
     {
         public:
 
             TextureViewParameters(const TextureViewParameters& ) = default;
-            TextureViewParameters(VkImageAspectFlags aspects, std::array<uint32_t, 2> layerRange = {0, 1});
+            TextureViewParameters(VkImageAspectFlags aspects, std::array<uint32_t, 2> layerRange = {0, 1}, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS});
 
             void setFormat(VkFormat format);
             void setViewType(VkImageViewType viewType);
@@ -64,85 +82,127 @@ namespace s3dl
             VkImageViewCreateInfo _view;
     };
 
-    class TextureArray
+    class TextureArray: public MemoryResource
     {
         public:
 
-            TextureArray(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t layerCount);
+            static uint32_t getMipLevelCount(const uvec2& size);
+
+            TextureArray(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t layerCount, bool mipmapped = false);
+            TextureArray(const CompressedTextureData& textureData, VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT);
             TextureArray(const TextureArray& textureArray) = delete;
 
             TextureArray& operator=(const TextureArray& textureArray) = delete;
 
-            void fillFromTextureData(const TextureData& textureData, uint32_t layer);
-            void fillFromBuffer(const Buffer& buffer, uint32_t firstLayer, uint32_t layerCount);
-            void fillFromTextureArray(const TextureArray& textureArray, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount);
-            void fillFromTexture(const Texture& texture, uint32_t dstLayer);
+            void fillFromTextureData(const TextureData& textureData, uint32_t layer, TransferBatch* batch = nullptr);
+            void fillFromBuffer(const Buffer& buffer, uint32_t firstLayer, uint32_t layerCount, TransferBatch* batch = nullptr, uint64_t bufferOffset = 0);
+            void fillFromTextureArray(const TextureArray& textureArray, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount, TransferBatch* batch = nullptr);
+            void fillFromTexture(const Texture& texture, uint32_t dstLayer, TransferBatch* batch = nullptr);
+            void fillFromCompressedTextureData(const CompressedTextureData& textureData, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount, TransferBatch* batch = nullptr);
+            void generateMipmaps(TransferBatch* batch = nullptr);
 
             void setSampler(const TextureSampler& sampler);
 
-            void updateLayoutState(VkImageLayout layout) const;
-            void setLayout(VkImageLayout layout) const;
+            void updateLayoutState(VkImageLayout layout, std::array<uint32_t, 2> layerRange = {0, VK_REMAINING_ARRAY_LAYERS}, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            void setLayout(VkImageLayout layout, TransferBatch* batch = nullptr) const;
+            void setLayout(VkImageLayout layout, ImageBarrierBatch& barriers, std::array<uint32_t, 2> layerRange = {0, VK_REMAINING_ARRAY_LAYERS}, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            void setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout, std::array<uint32_t, 2> layerRange = {0, VK_REMAINING_ARRAY_LAYERS}, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            VkImageLayout getLayout(uint32_t layer = 0, uint32_t mipLevel = 0) const;
 
             VkFormat getFormat() const;
 
             TextureData getTextureData(uint32_t layer) const;
+            ReadbackHandle getTextureDataAsync(RenderTarget& target, uint32_t layer) const;
+            ReadbackHandle getTextureDataAsync(TransferBatch& batch, uint32_t layer) const;
             const uvec2& getSize() const;
+            uint32_t getMipLevels() const;
 
             VkImage getVulkanImage() const;
             VkImageView getVulkanImageView(const TextureViewParameters& viewParameters) const;
+            ImageViewPinHandle pinVulkanImageView(const TextureViewParameters& viewParameters) const;
+            void prewarmVulkanImageViews(const std::vector<TextureViewParameters>& viewParameters) const;
             VkSampler getVulkanSampler() const;
 
+            bool isRelocatable() const;
+
             ~TextureArray();
 
         protected:
 
+            TextureArray(const CompressedTextureData& textureData, VkImageUsageFlags usage, uint32_t layerCount);
+
+            void createVulkanImage();
+            void relocate(VkCommandBuffer commandBuffer, RetiredResource& retiredResource);
+            void transitionTo(const std::vector<VkImageLayout>& layouts, ImageBarrierBatch& barriers) const;
+            void restoreLayouts(const std::vector<VkImageLayout>& layouts, ImageBarrierBatch& barriers) const;
+            void addTransitions(ImageBarrierBatch& barriers, VkImage image, const std::vector<VkImageLayout>& oldLayouts, const std::vector<VkImageLayout>& newLayouts) const;
+            void recordMipmapGeneration(VkCommandBuffer commandBuffer, uint32_t firstLayer, uint32_t layerCount) const;
+            ReadbackHandle recordReadback(VkCommandBuffer commandBuffer, uint32_t layer) const;
+
             static VkImageAspectFlags getAvailableAspects(VkFormat format);
+            static std::array<uint32_t, 2> resolveRange(std::array<uint32_t, 2> range, uint32_t count);
+            static VkFormat getCompressedTextureFormat(const CompressedTextureData& textureData);
 
             uvec2 _size;
             uint32_t _layerCount;
+            uint32_t _mipLevels;
             VkFormat _format;
             VkImageTiling _tiling;
             VkImageUsageFlags _usage;
 
-            VkDeviceMemory _vulkanImageMemory;
+            MemoryAllocation _imageMemory;
             VkImage _vulkanImage;
-            mutable std::unordered_map<TextureViewParameters, VkImageView, TextureViewParameters::Hasher, TextureViewParameters::Comparator> _vulkanImageViews;
-            const TextureSampler* _sampler;
-            bool _deleteSampler;
+            SamplerHandle _sampler;
+
+            mutable std::vector<VkImageLayout> _layouts;
 
-            mutable VkImageLayout _currentLayout;
+        friend UploadManager;
     };
 
     class Texture: private TextureArray
     {
         public:
 
-            Texture(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage);
+            Texture(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, bool mipmapped = false);
+            Texture(const CompressedTextureData& textureData, VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT);
             Texture(const Texture& texture) = delete;
 
             Texture& operator=(const Texture& texture) = delete;
 
-            void fillFromTextureData(const TextureData& textureData);
-            void fillFromBuffer(const Buffer& buffer);
-            void fillFromTextureArray(const TextureArray& textureArray, uint32_t srcLayer);
-            void fillFromTexture(const Texture& texture);
+            void fillFromTextureData(const TextureData& textureData, TransferBatch* batch = nullptr);
+            void fillFromBuffer(const Buffer& buffer, TransferBatch* batch = nullptr, uint64_t bufferOffset = 0);
+            void fillFromTextureArray(const TextureArray& textureArray, uint32_t srcLayer, TransferBatch* batch = nullptr);
+            void fillFromTexture(const Texture& texture, TransferBatch* batch = nullptr);
+            void fillFromCompressedTextureData(const CompressedTextureData& textureData, TransferBatch* batch = nullptr);
+            void generateMipmaps(TransferBatch* batch = nullptr);
 
             void setSampler(const TextureSampler& sampler);
 
-            void updateLayoutState(VkImageLayout layout) const;
-            void setLayout(VkImageLayout layout) const;
+            void updateLayoutState(VkImageLayout layout, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            void setLayout(VkImageLayout layout, TransferBatch* batch = nullptr) const;
+            void setLayout(VkImageLayout layout, ImageBarrierBatch& barriers, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            void setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout, std::array<uint32_t, 2> mipRange = {0, VK_REMAINING_MIP_LEVELS}) const;
+            VkImageLayout getLayout(uint32_t mipLevel = 0) const;
 
             VkFormat getFormat() const;
 
             TextureData getTextureData() const;
+            ReadbackHandle getTextureDataAsync(RenderTarget& target) const;
+            ReadbackHandle getTextureDataAsync(TransferBatch& batch) const;
             const uvec2& getSize() const;
+            uint32_t getMipLevels() const;
 
             VkImage getVulkanImage() const;
             VkImageView getVulkanImageView(const TextureViewParameters& viewParameters) const;
+            ImageViewPinHandle pinVulkanImageView(const TextureViewParameters& viewParameters) const;
+            void prewarmVulkanImageViews(const std::vector<TextureViewParameters>& viewParameters) const;
             VkSampler getVulkanSampler() const;
 
             ~Texture();
         
         friend TextureArray;
+        friend UploadManager;
+        friend UploadScheduler;
+        friend TextureStreamer;
     };
 }
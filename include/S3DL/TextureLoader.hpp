@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/UploadManager.hpp>
+
+namespace s3dl
+{
+    enum class TextureLoadState
+    {
+        Queued,
+        Decoding,
+        Decoded,
+        Uploading,
+        Ready,
+        Failed
+    };
+
+    struct TextureLoadTimings
+    {
+        float queueTime;
+        float decodeTime;
+        float stagingTime;
+        float uploadTime;
+    };
+
+    class TextureLoadRequest
+    {
+        public:
+
+            TextureLoadRequest(const std::string& filename);
+            TextureLoadRequest(const TextureLoadRequest& request) = delete;
+
+            TextureLoadRequest& operator=(const TextureLoadRequest& request) = delete;
+
+            const std::string& getFilename() const;
+            TextureLoadState getState() const;
+            bool isReady() const;
+            bool hasFailed() const;
+            std::string getError() const;
+
+            Texture& getTexture();
+            const Texture& getTexture() const;
+            TextureLoadTimings getTimings() const;
+
+            ~TextureLoadRequest();
+
+        private:
+
+            std::string _filename;
+            TextureLoadState _state;
+            std::string _error;
+
+            uvec2 _size;
+            Buffer* _stagingBuffer;
+            Texture* _texture;
+            UploadTicket _ticket;
+
+            std::chrono::steady_clock::time_point _queueStart;
+            std::chrono::steady_clock::time_point _uploadStart;
+            TextureLoadTimings _timings;
+
+            mutable std::mutex _mutex;
+
+        friend TextureLoader;
+    };
+
+    typedef std::shared_ptr<TextureLoadRequest> TextureHandle;
+
+    class TextureLoader
+    {
+        public:
+
+            TextureLoader(uint32_t threadCount = std::thread::hardware_concurrency(), VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
+            TextureLoader(const TextureLoader& loader) = delete;
+
+            TextureLoader& operator=(const TextureLoader& loader) = delete;
+
+            TextureHandle load(const std::string& filename);
+
+            void update();
+            void wait(const TextureHandle& handle);
+            void waitIdle();
+
+            uint32_t getThreadCount() const;
+            uint32_t getPendingCount() const;
+            TextureLoadTimings getTotalTimings() const;
+
+            ~TextureLoader();
+
+        private:
+
+            static float getElapsedTime(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end);
+            static void addTimings(TextureLoadTimings& totalTimings, const TextureLoadTimings& timings);
+
+            void decode();
+
+            VkFormat _format;
+
+            std::vector<std::thread> _workers;
+            bool _stopping;
+
+            std::deque<TextureHandle> _queuedRequests;
+            std::deque<TextureHandle> _decodedRequests;
+            std::vector<TextureHandle> _uploadingRequests;
+            uint32_t _decodingCount;
+
+            mutable std::mutex _mutex;
+            std::condition_variable _queueCondition;
+            std::condition_variable _decodedCondition;
+
+            TextureLoadTimings _totalTimings;
+    };
+}
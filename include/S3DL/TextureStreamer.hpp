@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/Texture.hpp>
+#include <S3DL/UploadScheduler.hpp>
+
+namespace s3dl
+{
+    enum class TextureResidency
+    {
+        Streaming,
+        Resident,
+        Cancelled
+    };
+
+    struct TextureStreamerStatistics
+    {
+        uint32_t streamingTextures;
+        uint32_t pendingLevels;
+        uint64_t streamedBytes;
+    };
+
+    class StreamedTexture
+    {
+        public:
+
+            StreamedTexture(const StreamedTexture& texture) = delete;
+
+            StreamedTexture& operator=(const StreamedTexture& texture) = delete;
+
+            TextureResidency getResidency() const;
+            uint32_t getResidentMipLevel() const;
+            uint32_t getMipLevels() const;
+
+            ~StreamedTexture();
+
+        private:
+
+            StreamedTexture(Texture& texture, const TextureSampler& sampler);
+
+            Texture* _texture;
+            TextureSampler _sampler;
+
+            TextureResidency _residency;
+            uint32_t _residentMipLevel;
+            std::vector<ScheduledUploadHandle> _levelUploads;
+
+        friend TextureStreamer;
+    };
+
+    typedef std::shared_ptr<StreamedTexture> StreamedTextureHandle;
+
+    class TextureStreamer
+    {
+        public:
+
+            static const uint32_t DEFAULT_IMMEDIATE_SIZE = 64;
+
+            TextureStreamer(uint32_t immediateSize = DEFAULT_IMMEDIATE_SIZE);
+            TextureStreamer(const TextureStreamer& streamer) = delete;
+
+            TextureStreamer& operator=(const TextureStreamer& streamer) = delete;
+
+            static std::vector<TextureData> generateMipChain(const TextureData& textureData, uint32_t mipLevels);
+
+            StreamedTextureHandle stream(Texture& texture, const TextureData& textureData, int32_t priority = 0, const TextureSampler& sampler = TextureSampler());
+            void cancel(const StreamedTextureHandle& texture);
+            void cancel(const TextureArray& textureArray);
+
+            void update();
+
+            void setImmediateSize(uint32_t immediateSize);
+            uint32_t getImmediateSize() const;
+            TextureStreamerStatistics getStatistics() const;
+
+            ~TextureStreamer();
+
+        private:
+
+            static void clampSampler(StreamedTexture& texture);
+            static void cancelUploads(StreamedTexture& texture);
+
+            uint32_t _immediateSize;
+
+            std::vector<StreamedTextureHandle> _streamingTextures;
+
+            TextureStreamerStatistics _statistics;
+
+            mutable std::mutex _mutex;
+    };
+}
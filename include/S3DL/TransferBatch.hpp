@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/Readback.hpp>
+
+namespace s3dl
+{
+    class TransferBatch
+    {
+        public:
+
+            static const uint64_t STAGING_CHUNK_SIZE = 4 * 1024 * 1024;
+            static const uint64_t STAGING_ALIGNMENT = 16;
+
+            TransferBatch();
+            TransferBatch(const TransferBatch& batch) = delete;
+
+            TransferBatch& operator=(const TransferBatch& batch) = delete;
+
+            std::pair<const Buffer*, uint64_t> stage(const void* data, uint64_t size);
+            VkCommandBuffer getVulkanCommandBuffer();
+
+            bool isEmpty() const;
+            void submit();
+
+            ~TransferBatch();
+
+        private:
+
+            void addReadback(const ReadbackHandle& readback);
+            void retire(Buffer* buffer);
+            void releaseResources();
+
+            VkCommandBuffer _commandBuffer;
+            std::thread::id _commandBufferOwner;
+            std::vector<Buffer*> _stagingBuffers;
+            uint64_t _stagingOffset;
+
+            std::vector<ReadbackHandle> _readbacks;
+            std::vector<Buffer*> _retiredBuffers;
+
+        friend Buffer;
+        friend TextureArray;
+        friend GrowableBuffer;
+    };
+}
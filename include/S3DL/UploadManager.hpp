@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+
+namespace s3dl
+{
+    typedef uint64_t UploadTicket;
+
+    struct UploadBatch
+    {
+        UploadTicket ticket;
+
+        VkCommandBuffer transferCommandBuffer;
+        VkCommandBuffer graphicsCommandBuffer;
+        VkSemaphore semaphore;
+        VkFence fence;
+
+        std::vector<Buffer*> stagingBuffers;
+        std::vector<VkBufferMemoryBarrier> bufferAcquireBarriers;
+        std::vector<VkImageMemoryBarrier> imageAcquireBarriers;
+
+        std::vector<std::pair<const TextureArray*, uint32_t>> mipmapLayers;
+        std::vector<VkImageMemoryBarrier> mipmapBarriers;
+    };
+
+    class UploadManager
+    {
+        public:
+
+            UploadManager();
+            UploadManager(const UploadManager& manager) = delete;
+
+            UploadManager& operator=(const UploadManager& manager) = delete;
+
+            UploadTicket upload(Buffer& buffer, const void* data, uint64_t size, uint64_t offset = 0);
+            UploadTicket upload(Buffer& buffer, Buffer* stagingBuffer, uint64_t size, uint64_t offset = 0);
+            UploadTicket upload(TextureArray& textureArray, const TextureData& textureData, uint32_t layer);
+            UploadTicket upload(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer);
+            UploadTicket upload(Texture& texture, const TextureData& textureData);
+            UploadTicket upload(Texture& texture, Buffer* stagingBuffer);
+            UploadTicket uploadMipLevel(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer, uint32_t mipLevel);
+
+            void flush();
+            bool isComplete(UploadTicket ticket);
+            void wait(UploadTicket ticket);
+            void waitIdle();
+
+            bool hasDedicatedTransferQueue() const;
+
+            ~UploadManager();
+
+        private:
+
+            UploadTicket uploadTexture(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer, uint32_t mipLevel, bool generateMipmaps);
+
+            static VkCommandPool createCommandPool(uint32_t queueFamily);
+
+            void beginBatch();
+            void collectCompletedBatches();
+            void destroyBatch(UploadBatch& batch);
+
+            VkCommandPool _transferCommandPool;
+            VkCommandPool _graphicsCommandPool;
+
+            UploadTicket _nextTicket;
+            bool _recording;
+            UploadBatch _currentBatch;
+            std::deque<UploadBatch> _pendingBatches;
+
+            mutable std::recursive_mutex _mutex;
+    };
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include <S3DL/types.hpp>
+#include <S3DL/UploadManager.hpp>
+
+namespace s3dl
+{
+    struct UploadSchedulerStatistics
+    {
+        uint32_t queueDepth;
+        uint64_t queuedBytes;
+        uint32_t uploadsLastFrame;
+        uint64_t bytesLastFrame;
+        uint64_t totalBytes;
+        uint32_t missedDeadlines;
+    };
+
+    class ScheduledUpload
+    {
+        public:
+
+            static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+            ScheduledUpload(int32_t priority, uint64_t deadline, Buffer* stagingBuffer, uint64_t size);
+            ScheduledUpload(const ScheduledUpload& upload) = delete;
+
+            ScheduledUpload& operator=(const ScheduledUpload& upload) = delete;
+
+            int32_t getPriority() const;
+            uint64_t getDeadline() const;
+            uint64_t getSize() const;
+
+            bool isSubmitted() const;
+            bool isComplete() const;
+            UploadTicket getTicket() const;
+
+            ~ScheduledUpload();
+
+        private:
+
+            int32_t _priority;
+            uint64_t _deadline;
+            uint64_t _order;
+
+            Buffer* _stagingBuffer;
+            uint64_t _size;
+
+            Buffer* _buffer;
+            uint64_t _offset;
+            TextureArray* _textureArray;
+            uint32_t _layer;
+            uint32_t _mipLevel;
+            bool _singleLevel;
+
+            std::atomic<bool> _submitted;
+            UploadTicket _ticket;
+
+        friend UploadScheduler;
+    };
+
+    typedef std::shared_ptr<ScheduledUpload> ScheduledUploadHandle;
+
+    class UploadScheduler
+    {
+        public:
+
+            static const uint64_t DEFAULT_FRAME_BUDGET = 16 * 1024 * 1024;
+
+            UploadScheduler(uint64_t frameBudget = DEFAULT_FRAME_BUDGET);
+            UploadScheduler(const UploadScheduler& scheduler) = delete;
+
+            UploadScheduler& operator=(const UploadScheduler& scheduler) = delete;
+
+            static std::vector<ScheduledUploadHandle> selectUploads(std::vector<ScheduledUploadHandle>& queuedUploads, uint64_t frame, uint64_t frameBudget, UploadSchedulerStatistics& statistics);
+
+            ScheduledUploadHandle schedule(Buffer& buffer, const void* data, uint64_t size, uint64_t offset = 0, int32_t priority = 0, uint64_t deadline = ScheduledUpload::NO_DEADLINE);
+            ScheduledUploadHandle schedule(TextureArray& textureArray, const TextureData& textureData, uint32_t layer, int32_t priority = 0, uint64_t deadline = ScheduledUpload::NO_DEADLINE);
+            ScheduledUploadHandle schedule(Texture& texture, const TextureData& textureData, int32_t priority = 0, uint64_t deadline = ScheduledUpload::NO_DEADLINE);
+            ScheduledUploadHandle scheduleMipLevel(TextureArray& textureArray, const void* data, uint64_t size, uint32_t layer, uint32_t mipLevel, int32_t priority = 0, uint64_t deadline = ScheduledUpload::NO_DEADLINE);
+            void cancel(const ScheduledUploadHandle& upload);
+            void cancel(const TextureArray& textureArray);
+            void cancel(const Buffer& buffer);
+
+            void update(uint64_t frame);
+            void flush();
+
+            void setFrameBudget(uint64_t frameBudget);
+            uint64_t getFrameBudget() const;
+            UploadSchedulerStatistics getStatistics() const;
+
+            ~UploadScheduler();
+
+        private:
+
+            static bool isBefore(const ScheduledUploadHandle& a, const ScheduledUploadHandle& b);
+            static void dequeue(ScheduledUpload& upload, UploadSchedulerStatistics& statistics);
+
+            ScheduledUploadHandle enqueue(ScheduledUpload* upload);
+            void submit(ScheduledUpload& upload);
+
+            uint64_t _frameBudget;
+            uint64_t _nextOrder;
+
+            std::vector<ScheduledUploadHandle> _queuedUploads;
+
+            UploadSchedulerStatistics _statistics;
+
+            mutable std::mutex _mutex;
+    };
+}
@@ -11,7 +11,20 @@ namespace s3dl
     class RenderWindow;
     class RenderTexture;
 
+    struct ThreadCommandPool;
     class Device;
+    enum class MemoryUsage;
+    enum class MemoryCategory;
+    struct MemoryBlock;
+    struct MemoryAllocation;
+    struct MemoryStatistics;
+    struct MemoryCategoryUsage;
+    struct MemoryHeapBudget;
+    class MemoryAllocator;
+    struct RetiredResource;
+    class MemoryResource;
+    struct DefragmentationStatistics;
+    class MemoryDefragmenter;
 
     class Swapchain;
 
@@ -53,9 +66,43 @@ namespace s3dl
 
 
     class Buffer;
+    struct FrameRingAllocation;
+    class FrameRingBuffer;
+    struct StagingPoolStatistics;
+    class StagingBufferPool;
+    class StagingBuffer;
+    class SyncObjectPool;
+    class DeletionQueue;
+    struct UploadBatch;
+    class UploadManager;
+    struct UploadSchedulerStatistics;
+    class ScheduledUpload;
+    class UploadScheduler;
+    class TransferBatch;
+    class ImageBarrierBatch;
+    class Readback;
+    enum class TextureLoadState;
+    struct TextureLoadTimings;
+    class TextureLoadRequest;
+    class TextureLoader;
+    class GrowableBuffer;
+    template<typename T> class GpuBuffer;
+    template<typename T> class StorageBuffer;
+    template<typename T> class IndirectBuffer;
+    template<typename T> class TexelBuffer;
     typedef _vec4<unsigned char> Color;
     class TextureData;
+    class CompressedTextureData;
     class TextureSampler;
+    class CachedSampler;
+    class SamplerCache;
+    struct ImageViewPin;
+    struct ImageViewCacheStatistics;
+    class ImageViewCache;
+    enum class TextureResidency;
+    struct TextureStreamerStatistics;
+    class StreamedTexture;
+    class TextureStreamer;
     class TextureViewParameters;
     class TextureArray;
     class Texture;
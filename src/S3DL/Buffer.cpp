@@ -2,229 +2,221 @@
 
 namespace s3dl
 {
-    Buffer::Buffer(uint64_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) :
+    Buffer::Buffer(uint64_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool persistentMapping) :
         _size(size),
         _usage(usage),
-        _properties(properties),
+        _properties(0),
         _buffer(VK_NULL_HANDLE),
-        _deviceMemory(VK_NULL_HANDLE)
+        _memory{},
+        _mappedData(nullptr),
+        _relocatable(true)
     {
-        // Create the buffer itself
+        if (persistentMapping && !(properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+            throw std::runtime_error("Cannot persistently map a buffer whose memory is not host visible.");
 
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = _size;
-        bufferInfo.usage = _usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        create(properties, properties, persistentMapping);
+    }
 
-        VkResult result = vkCreateBuffer(Device::Active->getVulkanDevice(), &bufferInfo, nullptr, &_buffer);
-        if (result != VK_SUCCESS)
-            throw std::runtime_error("Failed to create buffer. VkResult: " + std::to_string(result));
-        
-        // Allocate memory to buffer
+    Buffer::Buffer(uint64_t size, VkBufferUsageFlags usage, MemoryUsage memoryUsage, bool persistentMapping) :
+        _size(size),
+        _usage(usage),
+        _properties(0),
+        _buffer(VK_NULL_HANDLE),
+        _memory{},
+        _mappedData(nullptr),
+        _relocatable(true)
+    {
+        if (persistentMapping && memoryUsage == MemoryUsage::GpuOnly)
+            throw std::runtime_error("Cannot persistently map a buffer whose memory is not host visible.");
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(Device::Active->getVulkanDevice(), _buffer, &memRequirements);
+        // GPU only buffers may end up in memory the host cannot see and then go through staging copies
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findSuitableMemory(memRequirements.memoryTypeBits, _properties);
+        if (memoryUsage == MemoryUsage::GpuOnly)
+            _usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-        result = vkAllocateMemory(Device::Active->getVulkanDevice(), &allocInfo, nullptr, &_deviceMemory);
-        if (result != VK_SUCCESS)
-            throw std::runtime_error("Failed to allocate buffer memory. VkResult: " + std::to_string(result));
+        VkMemoryPropertyFlags requiredProperties, preferredProperties;
+        MemoryAllocator::getMemoryUsageFlags(memoryUsage, requiredProperties, preferredProperties);
 
-        vkBindBufferMemory(Device::Active->getVulkanDevice(), _buffer, _deviceMemory, 0);
-
-        #ifndef NDEBUG
-        std::clog << "<S3DL Debug> VkBuffer of " + std::to_string(_size) + " bytes successfully created." << std::endl;
-        #endif
+        create(requiredProperties, preferredProperties, persistentMapping);
     }
 
-    void Buffer::setData(const void* data, uint64_t size, uint64_t offset)
+    void Buffer::setData(const void* data, uint64_t size, uint64_t offset, TransferBatch* batch)
     {
-        VkResult result;
-
         if (offset + size > _size)
             throw std::runtime_error("Cannot put " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes in buffer of size " + std::to_string(_size) + " bytes.");
 
-        if (_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        if (_mappedData != nullptr)
+        {
+            std::memcpy(_mappedData + offset, data, size);
+            Device::Active->getMemoryAllocator()->flush(_memory, offset, size);
+        }
+        else if (isHostVisible())
+        {
+            uint8_t* handle = static_cast<uint8_t*>(Device::Active->getMemoryAllocator()->map(_memory));
+            std::memcpy(handle + offset, data, size);
+            Device::Active->getMemoryAllocator()->flush(_memory, offset, size);
+            Device::Active->getMemoryAllocator()->unmap(_memory);
+        }
+        else if (batch == nullptr)
         {
-            void* handle;
-            
-            result = vkMapMemory(Device::Active->getVulkanDevice(), _deviceMemory, offset, size, 0, &handle);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to map buffer to memory. VkResult: " + std::to_string(result));
-            
-            std::memcpy(handle, data, size);
-            vkUnmapMemory(Device::Active->getVulkanDevice(), _deviceMemory);
+            TransferBatch transferBatch;
+            setData(data, size, offset, &transferBatch);
+            transferBatch.submit();
         }
         else
         {
-            // Create a staging buffer with the data
-
-            Buffer stagingBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-            stagingBuffer.setData(data, size, 0);
-
-            // Create a command buffer for data transfer
-
-            VkCommandBufferAllocateInfo allocInfo{};
-            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-            allocInfo.commandBufferCount = 1;
-
-            VkCommandBuffer commandBuffer;
-            result = vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to allocate command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
-
-            // Record transfer command
-
-            VkCommandBufferBeginInfo beginInfo{};
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-            result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to start recording command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
-
-            VkBufferCopy copyRegion{};
-            copyRegion.srcOffset = 0;
-            copyRegion.dstOffset = offset;
-            copyRegion.size = size;
-            vkCmdCopyBuffer(commandBuffer, stagingBuffer.getVulkanBuffer(), _buffer, 1, &copyRegion);
+            // Put the data in the staging memory of the batch and copy it on the GPU
 
-            result = vkEndCommandBuffer(commandBuffer);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to end recording command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
-
-            // Create fence to wait for transfer to end
-
-            VkFence transferFence;
-            VkFenceCreateInfo fenceCreateInfo{};
-            fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+            std::pair<const Buffer*, uint64_t> staging = batch->stage(data, size);
+            fillFromBuffer(*staging.first, size, staging.second, offset, batch);
+        }
+    }
 
-            result = vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to create fence for Buffer memory transfer. VkResult: " + std::to_string(result));
+    void Buffer::fillFromBuffer(const Buffer& buffer, uint64_t size, uint64_t srcOffset, uint64_t dstOffset, TransferBatch* batch)
+    {
+        if (srcOffset + size > buffer._size || dstOffset + size > _size)
+            throw std::runtime_error("Cannot copy " + std::to_string(size) + " bytes from buffer of size " + std::to_string(buffer._size) + " bytes at offset " + std::to_string(srcOffset) + " to buffer of size " + std::to_string(_size) + " bytes at offset " + std::to_string(dstOffset) + ".");
 
-            // Submit command and wait its end with the fence
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            fillFromBuffer(buffer, size, srcOffset, dstOffset, &transferBatch);
+            transferBatch.submit();
+            return;
+        }
 
-            VkSubmitInfo submitInfo{};
-            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
+        // Record transfer command
 
-            vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-            vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = srcOffset;
+        copyRegion.dstOffset = dstOffset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(batch->getVulkanCommandBuffer(), buffer._buffer, _buffer, 1, &copyRegion);
 
-            vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+        // Later commands of the batch and later submissions may use the written range
 
-            // Free command buffer and fence (the staging buffer is freed using Buffer class)
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = _buffer;
+        barrier.offset = dstOffset;
+        barrier.size = size;
 
-            vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-            vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
-        }
+        vkCmdPipelineBarrier(batch->getVulkanCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
     }
 
     std::vector<uint8_t> Buffer::getData() const
     {
         std::vector<uint8_t> data(_size);
-        VkResult result;
-        if (_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        getData(data.data(), _size);
+
+        return data;
+    }
+
+    void Buffer::getData(void* data, uint64_t size, uint64_t offset) const
+    {
+        if (offset + size > _size)
+            throw std::runtime_error("Cannot get " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes from buffer of size " + std::to_string(_size) + " bytes.");
+
+        if (_mappedData != nullptr)
+        {
+            Device::Active->getMemoryAllocator()->invalidate(_memory, offset, size);
+            std::memcpy(data, _mappedData + offset, size);
+        }
+        else if (isHostVisible())
         {
-            void* handle;
-                
-            result = vkMapMemory(Device::Active->getVulkanDevice(), _deviceMemory, 0, _size, 0, &handle);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to map buffer to memory. VkResult: " + std::to_string(result));
-            
-            std::memcpy(data.data(), handle, _size);
-            vkUnmapMemory(Device::Active->getVulkanDevice(), _deviceMemory);
+            uint8_t* handle = static_cast<uint8_t*>(Device::Active->getMemoryAllocator()->map(_memory));
+            Device::Active->getMemoryAllocator()->invalidate(_memory, offset, size);
+            std::memcpy(data, handle + offset, size);
+            Device::Active->getMemoryAllocator()->unmap(_memory);
         }
         else
         {
-            // Create a staging buffer
+            // Copy the requested range in a pooled staging buffer only as big as it
 
-            Buffer stagingBuffer(_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            StagingBuffer stagingBuffer(size, MemoryUsage::Readback);
+            stagingBuffer->fillFromBuffer(*this, size, offset, 0);
 
-            // Create a command buffer for data transfer
+            // Retrieve data, the staging buffer goes back to the pool even if the copy fails
 
-            VkCommandBufferAllocateInfo allocInfo{};
-            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-            allocInfo.commandBufferCount = 1;
+            stagingBuffer->invalidate(0, size);
+            std::memcpy(data, stagingBuffer->getMappedData(), size);
+        }
+    }
 
-            VkCommandBuffer commandBuffer;
-            result = vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to allocate command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
+    void Buffer::flush(uint64_t offset, uint64_t size) const
+    {
+        if (_mappedData == nullptr)
+            throw std::runtime_error("Cannot flush a buffer that is not persistently mapped.");
 
-            // Record transfer command
+        Device::Active->getMemoryAllocator()->flush(_memory, offset, size);
+    }
 
-            VkCommandBufferBeginInfo beginInfo{};
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    void Buffer::invalidate(uint64_t offset, uint64_t size) const
+    {
+        if (_mappedData == nullptr)
+            throw std::runtime_error("Cannot invalidate a buffer that is not persistently mapped.");
 
-            result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to start recording command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
+        Device::Active->getMemoryAllocator()->invalidate(_memory, offset, size);
+    }
 
-            VkBufferCopy copyRegion{};
-            copyRegion.srcOffset = 0;
-            copyRegion.dstOffset = 0;
-            copyRegion.size = _size;
-            vkCmdCopyBuffer(commandBuffer, _buffer, stagingBuffer._buffer, 1, &copyRegion);
+    bool Buffer::isHostCoherent() const
+    {
+        return _properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
 
-            result = vkEndCommandBuffer(commandBuffer);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to end recording command buffer for Buffer memory transfer. VkResult: " + std::to_string(result));
+    bool Buffer::isPersistentlyMapped() const
+    {
+        return _mappedData != nullptr;
+    }
 
-            // Create fence to wait for transfer to end
+    void Buffer::setRelocatable(bool relocatable)
+    {
+        _relocatable = relocatable;
+    }
 
-            VkFence transferFence;
-            VkFenceCreateInfo fenceCreateInfo{};
-            fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    bool Buffer::isRelocatable() const
+    {
+        // Pointers to the mapped memory have been handed out, and moving requires copying through the transfer stage
 
-            result = vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to create fence for Buffer memory transfer. VkResult: " + std::to_string(result));
+        const VkBufferUsageFlags transferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-            // Submit command and wait its end with the fence
+        return _relocatable && _mappedData == nullptr && (_usage & transferUsage) == transferUsage;
+    }
 
-            VkSubmitInfo submitInfo{};
-            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &commandBuffer;
+    uint64_t Buffer::getSize() const
+    {
+        return _size;
+    }
 
-            vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-            vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
+    ReadbackHandle Buffer::getDataAsync(RenderTarget& target, uint64_t size, uint64_t offset) const
+    {
+        // Read the buffer after the commands recorded so far in the frame, the result is there once the frame is done.
+        // Copies cannot be recorded inside a render pass, the current one is ended and the next pass begins after them
 
-            vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+        target.endRenderPass();
 
-            // Free command buffer and fence (the staging buffer is freed using Buffer class)
+        ReadbackHandle readback = recordReadback(target._swapchain->getCurrentCommandBuffer(), size, offset);
+        readback->_swapchain = target._swapchain;
+        readback->_frame = target._swapchain->getFrameCount();
 
-            vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-            vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
+        return readback;
+    }
 
-            // Retrieve data
+    ReadbackHandle Buffer::getDataAsync(TransferBatch& batch, uint64_t size, uint64_t offset) const
+    {
+        ReadbackHandle readback = recordReadback(batch.getVulkanCommandBuffer(), size, offset);
+        batch.addReadback(readback);
 
-            void* handle;
-                
-            result = vkMapMemory(Device::Active->getVulkanDevice(), stagingBuffer._deviceMemory, 0, _size, 0, &handle);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to map buffer to memory. VkResult: " + std::to_string(result));
-            
-            std::memcpy(data.data(), handle, _size);
-            vkUnmapMemory(Device::Active->getVulkanDevice(), stagingBuffer._deviceMemory);
-        }
+        return readback;
+    }
 
-        return data;
+    VkMemoryPropertyFlags Buffer::getMemoryProperties() const
+    {
+        return _properties;
     }
 
     VkBuffer Buffer::getVulkanBuffer() const
@@ -234,25 +226,131 @@ namespace s3dl
     
     Buffer::~Buffer()
     {
-        if (_buffer != VK_NULL_HANDLE)
-            vkDestroyBuffer(Device::Active->getVulkanDevice(), _buffer, nullptr);
-        
-        if (_deviceMemory != VK_NULL_HANDLE)
-            vkFreeMemory(Device::Active->getVulkanDevice(), _deviceMemory, nullptr);
+        // Uploads still queued must not write to the buffer once it is destroyed
+
+        if (Device::Active->getUploadScheduler() != nullptr)
+            Device::Active->getUploadScheduler()->cancel(*this);
+
+        if (_mappedData != nullptr)
+            Device::Active->getMemoryAllocator()->unmap(_memory);
+
+        // Frames in flight may still use the buffer, it is destroyed once they are done
+
+        RetiredResource retiredResource{};
+        retiredResource.buffer = _buffer;
+        retiredResource.allocation = _memory;
+        Device::Active->getDeletionQueue()->enqueue(retiredResource);
 
         #ifndef NDEBUG
-        std::clog << "<S3DL Debug> VkBuffer of " + std::to_string(_size) + " bytes successfully destroyed." << std::endl;
+        std::clog << "<S3DL Debug> VkBuffer of " + std::to_string(_size) + " bytes successfully queued for destruction." << std::endl;
         #endif
     }
     
-    uint32_t Buffer::findSuitableMemory(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+    void Buffer::relocate(VkCommandBuffer commandBuffer, RetiredResource& retiredResource)
+    {
+        retiredResource.buffer = _buffer;
+        retiredResource.allocation = _memory;
+
+        // Create an identical buffer in the same memory type
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = _size;
+        bufferInfo.usage = _usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkResult result = vkCreateBuffer(Device::Active->getVulkanDevice(), &bufferInfo, nullptr, &_buffer);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create buffer. VkResult: " + std::to_string(result));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(Device::Active->getVulkanDevice(), _buffer, &memRequirements);
+
+        _memory = Device::Active->getMemoryAllocator()->allocate(memRequirements, retiredResource.allocation.memoryType, true, retiredResource.allocation.category, this);
+
+        vkBindBufferMemory(Device::Active->getVulkanDevice(), _buffer, _memory.memory, _memory.offset);
+
+        // Copy the content, the old buffer is destroyed once no frame uses it anymore
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = 0;
+        copyRegion.dstOffset = 0;
+        copyRegion.size = _size;
+        vkCmdCopyBuffer(commandBuffer, retiredResource.buffer, _buffer, 1, &copyRegion);
+    }
+
+    ReadbackHandle Buffer::recordReadback(VkCommandBuffer commandBuffer, uint64_t size, uint64_t offset) const
+    {
+        if (offset + size > _size)
+            throw std::runtime_error("Cannot read back " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes from buffer of size " + std::to_string(_size) + " bytes.");
+        if (!(_usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+            throw std::runtime_error("Cannot read back a buffer created without VK_BUFFER_USAGE_TRANSFER_SRC_BIT.");
+
+        ReadbackHandle readback(new Readback(size, {0, 0}));
+
+        readback->recordBarriers(commandBuffer, true);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = offset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(commandBuffer, _buffer, readback->_buffer->_buffer, 1, &copyRegion);
+
+        readback->recordBarriers(commandBuffer, false);
+
+        return readback;
+    }
+
+    void Buffer::create(VkMemoryPropertyFlags requiredProperties, VkMemoryPropertyFlags preferredProperties, bool persistentMapping)
     {
-        const VkPhysicalDeviceMemoryProperties& memProperties = Device::Active->getPhysicalDevice().memoryProperties;
+        // Create the buffer itself
 
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-            if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-                return i;
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = _size;
+        bufferInfo.usage = _usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkResult result = vkCreateBuffer(Device::Active->getVulkanDevice(), &bufferInfo, nullptr, &_buffer);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create buffer. VkResult: " + std::to_string(result));
         
-        throw std::runtime_error("Failed to find suitable memory type for buffer creation.");
+        // Allocate memory to buffer, keeping the properties of the memory type actually chosen
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(Device::Active->getVulkanDevice(), _buffer, &memRequirements);
+
+        MemoryAllocator* allocator = Device::Active->getMemoryAllocator();
+        uint32_t memoryType = allocator->findMemoryType(memRequirements.memoryTypeBits, requiredProperties, preferredProperties);
+        _memory = allocator->allocate(memRequirements, memoryType, true, getMemoryCategory(), this);
+        _properties = allocator->getMemoryTypeFlags(memoryType);
+
+        vkBindBufferMemory(Device::Active->getVulkanDevice(), _buffer, _memory.memory, _memory.offset);
+
+        // Keep the memory mapped for the whole buffer lifetime if asked
+
+        if (persistentMapping)
+            _mappedData = static_cast<uint8_t*>(allocator->map(_memory));
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkBuffer of " + std::to_string(_size) + " bytes successfully created." << std::endl;
+        #endif
+    }
+
+    MemoryCategory Buffer::getMemoryCategory() const
+    {
+        if (_usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+            return MemoryCategory::Mesh;
+        if (_usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+            return MemoryCategory::Uniform;
+        if (!(_usage & ~(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)))
+            return MemoryCategory::Staging;
+
+        return MemoryCategory::Other;
+    }
+
+    bool Buffer::isHostVisible() const
+    {
+        return _properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     }
 }
@@ -0,0 +1,639 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    namespace
+    {
+        uint32_t readUint32(const std::vector<uint8_t>& data, uint64_t offset)
+        {
+            if (offset + 4 > data.size())
+                throw std::runtime_error("Unexpected end of compressed texture file.");
+
+            return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (static_cast<uint32_t>(data[offset + 3]) << 24);
+        }
+
+        uint64_t readUint64(const std::vector<uint8_t>& data, uint64_t offset)
+        {
+            return readUint32(data, offset) | (static_cast<uint64_t>(readUint32(data, offset + 4)) << 32);
+        }
+
+        uint8_t clampColor(int32_t value)
+        {
+            return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+        }
+
+        uint32_t getFourCC(const char* code)
+        {
+            return code[0] | (code[1] << 8) | (code[2] << 16) | (static_cast<uint32_t>(code[3]) << 24);
+        }
+
+        int32_t getBits(uint64_t bits, uint32_t high, uint32_t low)
+        {
+            return (bits >> low) & ((1ull << (high - low + 1)) - 1);
+        }
+
+        int32_t extendBits(int32_t value, uint32_t bitCount)
+        {
+            return (value << (8 - bitCount)) | (value >> (2*bitCount - 8));
+        }
+
+        uint32_t getEtcIndex(uint64_t bits, uint32_t x, uint32_t y)
+        {
+            // Texels are indexed column by column, with the most significant bits of the indices in the upper half
+
+            uint32_t p = 4*x + y;
+            return (((bits >> (16 + p)) & 1) << 1) | ((bits >> p) & 1);
+        }
+
+        void setTexel(uint8_t* texels, uint32_t x, uint32_t y, int32_t r, int32_t g, int32_t b)
+        {
+            uint8_t* texel = &texels[4*(4*y + x)];
+            texel[0] = clampColor(r);
+            texel[1] = clampColor(g);
+            texel[2] = clampColor(b);
+            texel[3] = 255;
+        }
+    }
+
+    bool CompressedTextureData::isFormatSupported(VkFormat format)
+    {
+        // BC and ETC2 are optional features, the formats are only usable if the device can sample them
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(Device::Active->getPhysicalDevice().getVulkanPhysicalDevice(), format, &formatProperties);
+
+        return formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+
+    bool CompressedTextureData::isFormatDecodable(VkFormat format)
+    {
+        switch (format)
+        {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    CompressedTextureData::CompressedTextureData(const std::string& filename) :
+        _format(VK_FORMAT_UNDEFINED),
+        _size(0, 0),
+        _layerCount(1),
+        _mipLevels(1),
+        _data(),
+        _offsets()
+    {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Failed to open file '" + filename + "'.");
+
+        _data.resize(file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(_data.data()), _data.size());
+        file.close();
+
+        static const uint8_t ktx2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        if (_data.size() >= 12 && std::memcmp(_data.data(), ktx2Identifier, 12) == 0)
+            loadKtx2();
+        else if (_data.size() >= 4 && std::memcmp(_data.data(), "DDS ", 4) == 0)
+            loadDds();
+        else
+            throw std::runtime_error("File '" + filename + "' is neither a KTX2 nor a DDS file.");
+    }
+
+    VkFormat CompressedTextureData::getFormat() const
+    {
+        return _format;
+    }
+
+    VkFormat CompressedTextureData::getDecodedFormat() const
+    {
+        return isSrgb(_format) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+
+    const uvec2& CompressedTextureData::getSize() const
+    {
+        return _size;
+    }
+
+    uvec2 CompressedTextureData::getLevelSize(uint32_t level) const
+    {
+        return {std::max(_size.x >> level, 1u), std::max(_size.y >> level, 1u)};
+    }
+
+    uint32_t CompressedTextureData::getLayerCount() const
+    {
+        return _layerCount;
+    }
+
+    uint32_t CompressedTextureData::getMipLevels() const
+    {
+        return _mipLevels;
+    }
+
+    uint64_t CompressedTextureData::getRawSize(uint32_t level) const
+    {
+        uvec2 levelSize = getLevelSize(level);
+
+        return static_cast<uint64_t>((levelSize.x + 3) / 4) * ((levelSize.y + 3) / 4) * getBlockSize(_format);
+    }
+
+    const uint8_t* CompressedTextureData::getRawData(uint32_t level, uint32_t layer) const
+    {
+        if (level >= _mipLevels || layer >= _layerCount)
+            throw std::range_error("Cannot access level " + std::to_string(level) + " of layer " + std::to_string(layer) + " of compressed texture of " + std::to_string(_mipLevels) + " levels and " + std::to_string(_layerCount) + " layers.");
+
+        return _data.data() + _offsets[level * _layerCount + layer];
+    }
+
+    TextureData CompressedTextureData::decode(uint32_t level, uint32_t layer) const
+    {
+        if (!isFormatDecodable(_format))
+            throw std::runtime_error("No CPU decoder for compressed format " + std::to_string(_format) + ".");
+
+        uvec2 levelSize = getLevelSize(level);
+        TextureData textureData(levelSize.x, levelSize.y);
+
+        const uint8_t* block = getRawData(level, layer);
+        uint32_t blockSize = getBlockSize(_format);
+
+        // Decode block by block, the blocks on the right and bottom edges may hang over the image
+
+        uint8_t texels[64];
+        for (uint32_t y = 0; y < levelSize.y; y += 4)
+        {
+            for (uint32_t x = 0; x < levelSize.x; x += 4)
+            {
+                switch (_format)
+                {
+                    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                        decodeBc1Block(block, texels, true);
+                        break;
+                    case VK_FORMAT_BC3_UNORM_BLOCK:
+                    case VK_FORMAT_BC3_SRGB_BLOCK:
+                        decodeBc1Block(block + 8, texels, false);
+                        decodeBc4Block(block, texels, 3);
+                        break;
+                    case VK_FORMAT_BC4_UNORM_BLOCK:
+                        std::memset(texels, 0, 64);
+                        decodeBc4Block(block, texels, 0);
+                        break;
+                    case VK_FORMAT_BC5_UNORM_BLOCK:
+                        std::memset(texels, 0, 64);
+                        decodeBc4Block(block, texels, 0);
+                        decodeBc4Block(block + 8, texels, 1);
+                        break;
+                    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+                    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+                        decodeEtc2Block(block, texels);
+                        break;
+                    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+                    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                        decodeEtc2Block(block + 8, texels);
+                        decodeEacBlock(block, texels, 3);
+                        break;
+                    default:
+                        break;
+                }
+
+                // Formats without alpha read as opaque, single channel ones as (r, 0, 0, 1) and two channel ones as (r, g, 0, 1)
+
+                if (_format == VK_FORMAT_BC1_RGB_UNORM_BLOCK || _format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || _format == VK_FORMAT_BC4_UNORM_BLOCK || _format == VK_FORMAT_BC5_UNORM_BLOCK)
+                    for (uint32_t i = 0; i < 16; i++)
+                        texels[4*i + 3] = 255;
+
+                for (uint32_t j = 0; j < 4 && y + j < levelSize.y; j++)
+                    for (uint32_t i = 0; i < 4 && x + i < levelSize.x; i++)
+                        std::memcpy(&textureData(x + i, y + j), &texels[4*(4*j + i)], 4);
+
+                block += blockSize;
+            }
+        }
+
+        return textureData;
+    }
+
+    uint32_t CompressedTextureData::getBlockSize(VkFormat format)
+    {
+        switch (format)
+        {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+            case VK_FORMAT_BC4_SNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+                return 8;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_BC5_SNORM_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    bool CompressedTextureData::isSrgb(VkFormat format)
+    {
+        switch (format)
+        {
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void CompressedTextureData::decodeBc1Block(const uint8_t* block, uint8_t* texels, bool punchThrough)
+    {
+        uint16_t color0 = block[0] | (block[1] << 8);
+        uint16_t color1 = block[2] | (block[3] << 8);
+        uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+        int32_t palette[4][4];
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint16_t color = (i == 0) ? color0 : color1;
+            uint32_t r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+
+            palette[i][0] = (r << 3) | (r >> 2);
+            palette[i][1] = (g << 2) | (g >> 4);
+            palette[i][2] = (b << 3) | (b >> 2);
+            palette[i][3] = 255;
+        }
+
+        // The color block of BC3 always uses four colors, BC1 switches to three and transparent black on the endpoint order,
+        // interpolated colors are rounded to nearest like the reference decoders do
+
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            if (!punchThrough || color0 > color1)
+            {
+                palette[2][j] = (2*palette[0][j] + palette[1][j] + 1) / 3;
+                palette[3][j] = (palette[0][j] + 2*palette[1][j] + 1) / 3;
+            }
+            else
+            {
+                palette[2][j] = (palette[0][j] + palette[1][j] + 1) / 2;
+                palette[3][j] = 0;
+            }
+        }
+
+        palette[2][3] = 255;
+        palette[3][3] = (!punchThrough || color0 > color1) ? 255 : 0;
+
+        for (uint32_t i = 0; i < 16; i++)
+            for (uint32_t j = 0; j < 4; j++)
+                texels[4*i + j] = palette[(indices >> (2*i)) & 3][j];
+    }
+
+    void CompressedTextureData::decodeBc4Block(const uint8_t* block, uint8_t* texels, uint32_t channel)
+    {
+        int32_t values[8];
+        values[0] = block[0];
+        values[1] = block[1];
+
+        if (values[0] > values[1])
+        {
+            for (int32_t i = 2; i < 8; i++)
+                values[i] = ((8 - i)*values[0] + (i - 1)*values[1] + 3) / 7;
+        }
+        else
+        {
+            for (int32_t i = 2; i < 6; i++)
+                values[i] = ((6 - i)*values[0] + (i - 1)*values[1] + 2) / 5;
+            values[6] = 0;
+            values[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < 6; i++)
+            indices |= static_cast<uint64_t>(block[2 + i]) << (8*i);
+
+        for (uint32_t i = 0; i < 16; i++)
+            texels[4*i + channel] = values[(indices >> (3*i)) & 7];
+    }
+
+    void CompressedTextureData::decodeEtc2Block(const uint8_t* block, uint8_t* texels)
+    {
+        static const int32_t modifierTable[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+        static const int32_t distanceTable[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < 8; i++)
+            bits = (bits << 8) | block[i];
+
+        bool differential = getBits(bits, 33, 33);
+        bool flip = getBits(bits, 32, 32);
+
+        int32_t base[2][3];
+
+        if (differential)
+        {
+            int32_t r = getBits(bits, 63, 59), g = getBits(bits, 55, 51), b = getBits(bits, 47, 43);
+            int32_t dr = (getBits(bits, 58, 56) ^ 4) - 4, dg = (getBits(bits, 50, 48) ^ 4) - 4, db = (getBits(bits, 42, 40) ^ 4) - 4;
+
+            if (r + dr < 0 || r + dr > 31)
+            {
+                // T mode, two base colors and a distance applied to the second one
+
+                int32_t c0[3] = {extendBits((getBits(bits, 60, 59) << 2) | getBits(bits, 57, 56), 4), extendBits(getBits(bits, 55, 52), 4), extendBits(getBits(bits, 51, 48), 4)};
+                int32_t c1[3] = {extendBits(getBits(bits, 47, 44), 4), extendBits(getBits(bits, 43, 40), 4), extendBits(getBits(bits, 39, 36), 4)};
+                int32_t d = distanceTable[(getBits(bits, 35, 34) << 1) | getBits(bits, 32, 32)];
+
+                int32_t paint[4][3];
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    paint[0][j] = c0[j];
+                    paint[1][j] = c1[j] + d;
+                    paint[2][j] = c1[j];
+                    paint[3][j] = c1[j] - d;
+                }
+
+                for (uint32_t y = 0; y < 4; y++)
+                    for (uint32_t x = 0; x < 4; x++)
+                        setTexel(texels, x, y, paint[getEtcIndex(bits, x, y)][0], paint[getEtcIndex(bits, x, y)][1], paint[getEtcIndex(bits, x, y)][2]);
+
+                return;
+            }
+            else if (g + dg < 0 || g + dg > 31)
+            {
+                // H mode, two base colors each with a distance applied in both directions
+
+                int32_t r0 = getBits(bits, 62, 59), g0 = (getBits(bits, 58, 56) << 1) | getBits(bits, 52, 52), b0 = (getBits(bits, 51, 51) << 3) | getBits(bits, 49, 47);
+                int32_t r1 = getBits(bits, 46, 43), g1 = getBits(bits, 42, 39), b1 = getBits(bits, 38, 35);
+
+                uint32_t distanceIndex = (getBits(bits, 34, 34) << 2) | (getBits(bits, 32, 32) << 1);
+                if (((r0 << 8) | (g0 << 4) | b0) >= ((r1 << 8) | (g1 << 4) | b1))
+                    distanceIndex |= 1;
+                int32_t d = distanceTable[distanceIndex];
+
+                int32_t c0[3] = {extendBits(r0, 4), extendBits(g0, 4), extendBits(b0, 4)};
+                int32_t c1[3] = {extendBits(r1, 4), extendBits(g1, 4), extendBits(b1, 4)};
+
+                int32_t paint[4][3];
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    paint[0][j] = c0[j] + d;
+                    paint[1][j] = c0[j] - d;
+                    paint[2][j] = c1[j] + d;
+                    paint[3][j] = c1[j] - d;
+                }
+
+                for (uint32_t y = 0; y < 4; y++)
+                    for (uint32_t x = 0; x < 4; x++)
+                        setTexel(texels, x, y, paint[getEtcIndex(bits, x, y)][0], paint[getEtcIndex(bits, x, y)][1], paint[getEtcIndex(bits, x, y)][2]);
+
+                return;
+            }
+            else if (b + db < 0 || b + db > 31)
+            {
+                // Planar mode, colors interpolated from an origin, a horizontal and a vertical color
+
+                int32_t o[3] = {extendBits(getBits(bits, 62, 57), 6), extendBits((getBits(bits, 56, 56) << 6) | getBits(bits, 54, 49), 7), extendBits((getBits(bits, 48, 48) << 5) | (getBits(bits, 44, 43) << 3) | getBits(bits, 41, 39), 6)};
+                int32_t h[3] = {extendBits((getBits(bits, 38, 34) << 1) | getBits(bits, 32, 32), 6), extendBits(getBits(bits, 31, 25), 7), extendBits(getBits(bits, 24, 19), 6)};
+                int32_t v[3] = {extendBits(getBits(bits, 18, 13), 6), extendBits(getBits(bits, 12, 6), 7), extendBits(getBits(bits, 5, 0), 6)};
+
+                for (int32_t y = 0; y < 4; y++)
+                {
+                    for (int32_t x = 0; x < 4; x++)
+                    {
+                        int32_t color[3];
+                        for (uint32_t j = 0; j < 3; j++)
+                            color[j] = (x*(h[j] - o[j]) + y*(v[j] - o[j]) + 4*o[j] + 2) >> 2;
+
+                        setTexel(texels, x, y, color[0], color[1], color[2]);
+                    }
+                }
+
+                return;
+            }
+
+            base[0][0] = extendBits(r, 5);
+            base[0][1] = extendBits(g, 5);
+            base[0][2] = extendBits(b, 5);
+            base[1][0] = extendBits(r + dr, 5);
+            base[1][1] = extendBits(g + dg, 5);
+            base[1][2] = extendBits(b + db, 5);
+        }
+        else
+        {
+            base[0][0] = extendBits(getBits(bits, 63, 60), 4);
+            base[0][1] = extendBits(getBits(bits, 55, 52), 4);
+            base[0][2] = extendBits(getBits(bits, 47, 44), 4);
+            base[1][0] = extendBits(getBits(bits, 59, 56), 4);
+            base[1][1] = extendBits(getBits(bits, 51, 48), 4);
+            base[1][2] = extendBits(getBits(bits, 43, 40), 4);
+        }
+
+        // Individual and differential modes, two subblocks side by side or on top of each other
+
+        int32_t tables[2] = {getBits(bits, 39, 37), getBits(bits, 36, 34)};
+
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                uint32_t subblock = flip ? (y >= 2) : (x >= 2);
+                uint32_t index = getEtcIndex(bits, x, y);
+
+                int32_t modifier = modifierTable[tables[subblock]][index & 1];
+                if (index & 2)
+                    modifier = -modifier;
+
+                setTexel(texels, x, y, base[subblock][0] + modifier, base[subblock][1] + modifier, base[subblock][2] + modifier);
+            }
+        }
+    }
+
+    void CompressedTextureData::decodeEacBlock(const uint8_t* block, uint8_t* texels, uint32_t channel)
+    {
+        static const int32_t modifierTable[16][8] = {
+            {-3, -6,  -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5,  -8, -13, 1, 4, 7, 12},
+            {-2, -4,  -6, -13, 1, 3, 5, 12},
+            {-3, -6,  -8, -12, 2, 5, 7, 11},
+            {-3, -7,  -9, -11, 2, 6, 8, 10},
+            {-4, -7,  -8, -11, 3, 6, 7, 10},
+            {-3, -5,  -8, -11, 2, 4, 7, 10},
+            {-2, -6,  -8, -10, 1, 5, 7,  9},
+            {-2, -5,  -8, -10, 1, 4, 7,  9},
+            {-2, -4,  -8, -10, 1, 3, 7,  9},
+            {-2, -5,  -7, -10, 1, 4, 6,  9},
+            {-3, -4,  -7, -10, 2, 3, 6,  9},
+            {-1, -2,  -3, -10, 0, 1, 2,  9},
+            {-4, -6,  -8,  -9, 3, 5, 7,  8},
+            {-3, -5,  -7,  -9, 2, 4, 6,  8}
+        };
+
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < 8; i++)
+            bits = (bits << 8) | block[i];
+
+        int32_t base = (bits >> 56) & 255;
+        int32_t multiplier = (bits >> 52) & 15;
+        const int32_t* modifiers = modifierTable[(bits >> 48) & 15];
+
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                uint32_t p = 4*x + y;
+                uint32_t index = (bits >> (45 - 3*p)) & 7;
+
+                texels[4*(4*y + x) + channel] = clampColor(base + modifiers[index]*multiplier);
+            }
+        }
+    }
+
+    void CompressedTextureData::loadDds()
+    {
+        // DDS_HEADER follows the magic number, DDS_PIXELFORMAT is at offset 76 of it
+
+        const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        const uint32_t DDPF_FOURCC = 0x4;
+        const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+        const uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+        if (readUint32(_data, 4) != 124)
+            throw std::runtime_error("Invalid DDS header size.");
+
+        uint32_t flags = readUint32(_data, 8);
+        _size = {readUint32(_data, 16), readUint32(_data, 12)};
+        _mipLevels = (flags & DDSD_MIPMAPCOUNT) ? std::max(readUint32(_data, 28), 1u) : 1;
+
+        uint32_t pixelFormatFlags = readUint32(_data, 80);
+        uint32_t fourCC = readUint32(_data, 84);
+        uint32_t caps2 = readUint32(_data, 112);
+
+        if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+            throw std::runtime_error("Cube map and volume DDS files are not supported.");
+        if (!(pixelFormatFlags & DDPF_FOURCC))
+            throw std::runtime_error("Uncompressed DDS files are not supported.");
+
+        uint64_t offset = 128;
+
+        if (fourCC == getFourCC("DX10"))
+        {
+            // The extended header gives the DXGI format and the array size
+
+            uint32_t dxgiFormat = readUint32(_data, 128);
+            uint32_t miscFlag = readUint32(_data, 136);
+            _layerCount = std::max(readUint32(_data, 140), 1u);
+            offset += 20;
+
+            if (miscFlag & 0x4)
+                throw std::runtime_error("Cube map DDS files are not supported.");
+
+            switch (dxgiFormat)
+            {
+                case 71: _format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK; break;
+                case 72: _format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK; break;
+                case 77: _format = VK_FORMAT_BC3_UNORM_BLOCK; break;
+                case 78: _format = VK_FORMAT_BC3_SRGB_BLOCK; break;
+                case 80: _format = VK_FORMAT_BC4_UNORM_BLOCK; break;
+                case 81: _format = VK_FORMAT_BC4_SNORM_BLOCK; break;
+                case 83: _format = VK_FORMAT_BC5_UNORM_BLOCK; break;
+                case 84: _format = VK_FORMAT_BC5_SNORM_BLOCK; break;
+                case 98: _format = VK_FORMAT_BC7_UNORM_BLOCK; break;
+                case 99: _format = VK_FORMAT_BC7_SRGB_BLOCK; break;
+                default:
+                    throw std::runtime_error("Unsupported DXGI format " + std::to_string(dxgiFormat) + " in DDS file.");
+            }
+        }
+        else if (fourCC == getFourCC("DXT1"))
+            _format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        else if (fourCC == getFourCC("DXT5"))
+            _format = VK_FORMAT_BC3_UNORM_BLOCK;
+        else if (fourCC == getFourCC("ATI1") || fourCC == getFourCC("BC4U"))
+            _format = VK_FORMAT_BC4_UNORM_BLOCK;
+        else if (fourCC == getFourCC("BC4S"))
+            _format = VK_FORMAT_BC4_SNORM_BLOCK;
+        else if (fourCC == getFourCC("ATI2") || fourCC == getFourCC("BC5U"))
+            _format = VK_FORMAT_BC5_UNORM_BLOCK;
+        else if (fourCC == getFourCC("BC5S"))
+            _format = VK_FORMAT_BC5_SNORM_BLOCK;
+        else
+            throw std::runtime_error("Unsupported FourCC code in DDS file.");
+
+        // Every level of the first layer, then every level of the next one
+
+        _offsets.resize(_mipLevels * _layerCount);
+        for (uint32_t layer = 0; layer < _layerCount; layer++)
+        {
+            for (uint32_t level = 0; level < _mipLevels; level++)
+            {
+                _offsets[level * _layerCount + layer] = offset;
+                offset += getRawSize(level);
+            }
+        }
+
+        if (offset > _data.size())
+            throw std::runtime_error("Unexpected end of DDS file.");
+    }
+
+    void CompressedTextureData::loadKtx2()
+    {
+        _format = static_cast<VkFormat>(readUint32(_data, 12));
+        _size = {readUint32(_data, 20), readUint32(_data, 24)};
+        uint32_t depth = readUint32(_data, 28);
+        _layerCount = std::max(readUint32(_data, 32), 1u);
+        uint32_t faceCount = readUint32(_data, 36);
+        _mipLevels = std::max(readUint32(_data, 40), 1u);
+        uint32_t supercompressionScheme = readUint32(_data, 44);
+
+        if (getBlockSize(_format) == 0)
+            throw std::runtime_error("Unsupported format " + std::to_string(_format) + " in KTX2 file.");
+        if (depth > 1 || faceCount != 1)
+            throw std::runtime_error("Cube map and volume KTX2 files are not supported.");
+        if (supercompressionScheme != 0)
+            throw std::runtime_error("Supercompressed KTX2 files are not supported.");
+
+        // The level index follows the header, each level holds every layer one after the other
+
+        _offsets.resize(_mipLevels * _layerCount);
+        for (uint32_t level = 0; level < _mipLevels; level++)
+        {
+            uint64_t offset = readUint64(_data, 80 + 24*level);
+            uint64_t length = readUint64(_data, 88 + 24*level);
+
+            if (length < getRawSize(level) * _layerCount || offset + length > _data.size())
+                throw std::runtime_error("Invalid level " + std::to_string(level) + " in KTX2 file.");
+
+            for (uint32_t layer = 0; layer < _layerCount; layer++)
+                _offsets[level * _layerCount + layer] = offset + layer * getRawSize(level);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    DeletionQueue::DeletionQueue() :
+        _submissionCount(0),
+        _swapchains(),
+        _resources()
+    {
+    }
+
+    void DeletionQueue::enqueue(const RetiredResource& resource)
+    {
+        // The defragmenter must not move a resource that no longer exists, even though its memory is still in use
+
+        if (resource.allocation.block != nullptr)
+            Device::Active->getMemoryAllocator()->detachResource(resource.allocation);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Every frame begun so far, by any swapchain, may use the resource
+
+        _resources.push_back(resource);
+        _resources.back().submission = _submissionCount;
+    }
+
+    void DeletionQueue::collect()
+    {
+        std::vector<RetiredResource> resources;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // Frames of every swapchain share the submission counter, a resource can be destroyed once each swapchain
+            // has completed all its frames begun before the resource was queued
+
+            uint64_t completedSubmissionCount = _submissionCount;
+            for (const Swapchain* swapchain: _swapchains)
+                completedSubmissionCount = std::min(completedSubmissionCount, swapchain->getCompletedSubmissionCount());
+
+            // Resources are queued in submission order, stop at the first one a running frame may still use
+
+            while (!_resources.empty() && _resources.front().submission <= completedSubmissionCount)
+            {
+                resources.push_back(_resources.front());
+                _resources.pop_front();
+            }
+        }
+
+        for (const RetiredResource& resource: resources)
+            destroy(resource);
+    }
+
+    void DeletionQueue::flush()
+    {
+        vkDeviceWaitIdle(Device::Active->getVulkanDevice());
+
+        std::deque<RetiredResource> resources;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            resources.swap(_resources);
+        }
+
+        for (const RetiredResource& resource: resources)
+            destroy(resource);
+    }
+
+    uint32_t DeletionQueue::getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _resources.size();
+    }
+
+    DeletionQueue::~DeletionQueue()
+    {
+        flush();
+    }
+
+    void DeletionQueue::addSwapchain(const Swapchain& swapchain)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (std::find(_swapchains.begin(), _swapchains.end(), &swapchain) == _swapchains.end())
+            _swapchains.push_back(&swapchain);
+    }
+
+    void DeletionQueue::removeSwapchain(const Swapchain& swapchain)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<const Swapchain*>::iterator it = std::find(_swapchains.begin(), _swapchains.end(), &swapchain);
+        if (it != _swapchains.end())
+            _swapchains.erase(it);
+    }
+
+    uint64_t DeletionQueue::beginSubmission()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _submissionCount++;
+    }
+
+    void DeletionQueue::destroy(const RetiredResource& resource)
+    {
+        if (resource.sampler != VK_NULL_HANDLE)
+            vkDestroySampler(Device::Active->getVulkanDevice(), resource.sampler, nullptr);
+        for (VkImageView imageView: resource.imageViews)
+            vkDestroyImageView(Device::Active->getVulkanDevice(), imageView, nullptr);
+        if (resource.image != VK_NULL_HANDLE)
+            vkDestroyImage(Device::Active->getVulkanDevice(), resource.image, nullptr);
+        if (resource.bufferView != VK_NULL_HANDLE)
+            vkDestroyBufferView(Device::Active->getVulkanDevice(), resource.bufferView, nullptr);
+        if (resource.buffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(Device::Active->getVulkanDevice(), resource.buffer, nullptr);
+
+        Device::Active->getMemoryAllocator()->free(resource.allocation);
+    }
+}
@@ -129,13 +129,172 @@ namespace s3dl
         return _presentQueue;
     }
 
+    VkQueue Device::getVulkanTransferQueue() const
+    {
+        return _transferQueue;
+    }
+
+    uint32_t Device::getGraphicsQueueFamily() const
+    {
+        return _graphicsQueueFamily;
+    }
+
+    uint32_t Device::getTransferQueueFamily() const
+    {
+        return _transferQueueFamily;
+    }
+
     VkCommandPool Device::getVulkanCommandPool() const
     {
         return _commandPool;
     }
 
+    VkCommandBuffer Device::acquireTransientCommandBuffer() const
+    {
+        // Each thread records in its own pool, so recording never needs a lock
+
+        ThreadCommandPool& threadPool = getThreadCommandPool();
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        {
+            std::lock_guard<std::mutex> lock(threadPool.freeCommandBuffersMutex);
+
+            if (!threadPool.freeCommandBuffers.empty())
+            {
+                commandBuffer = threadPool.freeCommandBuffers.back();
+                threadPool.freeCommandBuffers.pop_back();
+            }
+        }
+
+        // Released command buffers are reset here, by the thread owning the pool, as a reset needs the pool to be
+        // externally synchronized
+
+        if (commandBuffer != VK_NULL_HANDLE)
+        {
+            vkResetCommandBuffer(commandBuffer, 0);
+            return commandBuffer;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = threadPool.commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkResult result = vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate transient command buffer. VkResult: " + std::to_string(result));
+
+        return commandBuffer;
+    }
+
+    void Device::releaseTransientCommandBuffer(VkCommandBuffer commandBuffer, std::thread::id owner) const
+    {
+        // Must be called once the execution of the command buffer is complete. It goes back to the pool of the thread
+        // that acquired it, which may be another thread than the calling one
+
+        std::lock_guard<std::mutex> lock(_threadCommandPoolsMutex);
+
+        // A thread that released its resources destroyed its pool, and the command buffer with it
+
+        std::unordered_map<std::thread::id, ThreadCommandPool>::iterator it = _threadCommandPools.find(owner);
+        if (it == _threadCommandPools.end())
+            return;
+
+        std::lock_guard<std::mutex> poolLock(it->second.freeCommandBuffersMutex);
+        it->second.freeCommandBuffers.push_back(commandBuffer);
+    }
+
+    void Device::releaseThreadResources() const
+    {
+        // Worker threads call this before exiting so their command pool does not outlive them
+
+        std::lock_guard<std::mutex> lock(_threadCommandPoolsMutex);
+
+        std::unordered_map<std::thread::id, ThreadCommandPool>::iterator it = _threadCommandPools.find(std::this_thread::get_id());
+        if (it == _threadCommandPools.end())
+            return;
+
+        vkDestroyCommandPool(_device, it->second.commandPool, nullptr);
+        _threadCommandPools.erase(it);
+    }
+
+    VkResult Device::submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* submits, VkFence fence) const
+    {
+        // Queues are externally synchronized, and the transfer and present queues may alias the graphics queue
+
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        return vkQueueSubmit(queue, submitCount, submits, fence);
+    }
+
+    VkResult Device::present(const VkPresentInfoKHR& presentInfo) const
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        return vkQueuePresentKHR(_presentQueue, &presentInfo);
+    }
+
+    MemoryAllocator* Device::getMemoryAllocator() const
+    {
+        return _memoryAllocator;
+    }
+
+    StagingBufferPool* Device::getStagingBufferPool() const
+    {
+        return _stagingBufferPool;
+    }
+
+    SyncObjectPool* Device::getSyncObjectPool() const
+    {
+        return _syncObjectPool;
+    }
+
+    DeletionQueue* Device::getDeletionQueue() const
+    {
+        return _deletionQueue;
+    }
+
+    UploadManager* Device::getUploadManager() const
+    {
+        return _uploadManager;
+    }
+
+    UploadScheduler* Device::getUploadScheduler() const
+    {
+        return _uploadScheduler;
+    }
+
+    SamplerCache* Device::getSamplerCache() const
+    {
+        return _samplerCache;
+    }
+
+    ImageViewCache* Device::getImageViewCache() const
+    {
+        return _imageViewCache;
+    }
+
+    TextureStreamer* Device::getTextureStreamer() const
+    {
+        return _textureStreamer;
+    }
+
     Device::~Device()
     {
+        delete _textureStreamer;
+        delete _imageViewCache;
+        delete _samplerCache;
+        delete _uploadScheduler;
+        _uploadScheduler = nullptr;
+        delete _uploadManager;
+        delete _syncObjectPool;
+        delete _stagingBufferPool;
+        delete _deletionQueue;
+        delete _memoryAllocator;
+
+        for (std::pair<const std::thread::id, ThreadCommandPool>& threadPool: _threadCommandPools)
+            vkDestroyCommandPool(_device, threadPool.second.commandPool, nullptr);
+
         vkDestroyCommandPool(_device, _commandPool, nullptr);
 
         #ifndef NDEBUG
@@ -155,9 +314,11 @@ namespace s3dl
         {
             uint32_t graphicsFamily;
             uint32_t presentFamily;
+            uint32_t transferFamily;
 
             bool hasGraphicsFamily;
             bool hasPresentFamily;
+            bool hasTransferFamily;
         };
     }
 
@@ -172,9 +333,19 @@ namespace s3dl
         std::set<std::string> extensions(additionalExtensions.begin(), additionalExtensions.end());
         extensions.insert(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
+        // Memory budget queries are optional, enable them whenever the driver exposes them
+
+        bool memoryBudgetSupported = false;
+        for (const VkExtensionProperties& extension: _physicalDevice.extensions)
+            if (std::string(extension.extensionName) == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)
+                memoryBudgetSupported = true;
+
+        if (memoryBudgetSupported)
+            extensions.insert(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
         // Extract indices of the different queue families that can be needed
 
-        QueueFamilies families{0, 0, false, false};
+        QueueFamilies families{0, 0, 0, false, false, false};
         for (int i(0); i < _physicalDevice.queueFamilies.size(); i++)
         {
             if (_physicalDevice.queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
@@ -183,6 +354,14 @@ namespace s3dl
                 families.hasGraphicsFamily = true;
             }
 
+            // A transfer only family is usually backed by DMA engines that copy without disturbing rendering
+
+            if ((_physicalDevice.queueFamilies[i].queueFlags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == VK_QUEUE_TRANSFER_BIT)
+            {
+                families.transferFamily = i;
+                families.hasTransferFamily = true;
+            }
+
             if (target.hasVulkanSurface())
             {
                 VkBool32 support = false;
@@ -198,12 +377,15 @@ namespace s3dl
         if (!families.hasGraphicsFamily || (!families.hasPresentFamily && target.hasVulkanSurface()))
             throw std::runtime_error("Could not find all vulkan queue families required.");
 
+        if (!families.hasTransferFamily)
+            families.transferFamily = families.graphicsFamily;
+
         // Compute the different create infos for the queues
 
         float queuePriority = 1.0f;
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<uint32_t> queueFamilies = { families.graphicsFamily, families.presentFamily };
+        std::set<uint32_t> queueFamilies = { families.graphicsFamily, families.presentFamily, families.transferFamily };
 
         for (std::set<uint32_t>::iterator it = queueFamilies.begin(); it != queueFamilies.end(); it++)
         {
@@ -222,7 +404,7 @@ namespace s3dl
         // Create the device itself
 
         VkPhysicalDeviceFeatures deviceFeatures{};
-        deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.samplerAnisotropy = _physicalDevice.features.samplerAnisotropy;
 
         std::vector<const char*> deviceExtensions;
         for (const std::string& extension: extensions)
@@ -250,6 +432,10 @@ namespace s3dl
 
         vkGetDeviceQueue(_device, families.graphicsFamily, 0, &_graphicsQueue);
         vkGetDeviceQueue(_device, families.presentFamily, 0, &_presentQueue);
+        vkGetDeviceQueue(_device, families.transferFamily, 0, &_transferQueue);
+
+        _graphicsQueueFamily = families.graphicsFamily;
+        _transferQueueFamily = families.transferFamily;
 
         // Create the command pool
 
@@ -265,5 +451,43 @@ namespace s3dl
         #ifndef NDEBUG
         std::clog << "<S3DL Debug> VkCommandPool successfully created." << std::endl;
         #endif
+
+        // Create the device memory allocator, and the staging buffer pool and upload managers using it
+
+        _memoryAllocator = new MemoryAllocator(_physicalDevice, _device, memoryBudgetSupported);
+        _deletionQueue = new DeletionQueue();
+        _stagingBufferPool = new StagingBufferPool();
+        _syncObjectPool = new SyncObjectPool();
+        _uploadManager = new UploadManager();
+        _uploadScheduler = new UploadScheduler();
+        _samplerCache = new SamplerCache();
+        _imageViewCache = new ImageViewCache();
+        _textureStreamer = new TextureStreamer();
+    }
+
+    ThreadCommandPool& Device::getThreadCommandPool() const
+    {
+        std::lock_guard<std::mutex> lock(_threadCommandPoolsMutex);
+
+        std::unordered_map<std::thread::id, ThreadCommandPool>::iterator it = _threadCommandPools.find(std::this_thread::get_id());
+        if (it != _threadCommandPools.end())
+            return it->second;
+
+        // Short-lived command buffers, reset individually so they can be recycled
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = _graphicsQueueFamily;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        VkCommandPool commandPool;
+        VkResult result = vkCreateCommandPool(_device, &poolInfo, nullptr, &commandPool);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create thread command pool. VkResult: " + std::to_string(result));
+
+        ThreadCommandPool& threadPool = _threadCommandPools[std::this_thread::get_id()];
+        threadPool.commandPool = commandPool;
+
+        return threadPool;
     }
 }
@@ -0,0 +1,86 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    FrameRingBuffer::FrameRingBuffer(const Swapchain& swapchain, uint64_t frameSize, VkBufferUsageFlags usage) :
+        _swapchain(swapchain),
+        _frameSize(0),
+        _alignment(1),
+        _buffer(nullptr),
+        _region(swapchain.getCurrentImage()),
+        _head(0),
+        _frame(swapchain.getFrameCount())
+    {
+        // Sub-ranges bound as descriptors must respect the device offset alignments
+
+        const VkPhysicalDeviceLimits& limits = Device::Active->getPhysicalDevice().properties.limits;
+
+        if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+            _alignment = std::max<uint64_t>(_alignment, limits.minUniformBufferOffsetAlignment);
+        if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+            _alignment = std::max<uint64_t>(_alignment, limits.minStorageBufferOffsetAlignment);
+
+        _frameSize = (frameSize + _alignment - 1) / _alignment * _alignment;
+
+        // One region per swapchain image, each reused once the image's render fence has signaled
+
+        _buffer = new Buffer(_frameSize * swapchain.getImageCount(), usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+    }
+
+    FrameRingAllocation FrameRingBuffer::allocate(uint64_t size, uint64_t alignment)
+    {
+        reclaimRegion();
+
+        alignment = std::max(alignment, _alignment);
+        uint64_t offset = (_head + alignment - 1) / alignment * alignment;
+
+        if (offset + size > _frameSize)
+            throw std::runtime_error("Cannot allocate " + std::to_string(size) + " bytes in frame ring buffer: only " + std::to_string(_frameSize - std::min(offset, _frameSize)) + " bytes left for this frame.");
+
+        _head = offset + size;
+
+        FrameRingAllocation allocation;
+        allocation.buffer = _buffer->getVulkanBuffer();
+        allocation.offset = _region * _frameSize + offset;
+        allocation.size = size;
+        allocation.data = _buffer->getMappedData(allocation.offset);
+
+        return allocation;
+    }
+
+    uint64_t FrameRingBuffer::getFrameSize() const
+    {
+        return _frameSize;
+    }
+
+    uint64_t FrameRingBuffer::getUsedSize() const
+    {
+        if (_frame != _swapchain.getFrameCount())
+            return 0;
+
+        return _head;
+    }
+
+    VkBuffer FrameRingBuffer::getVulkanBuffer() const
+    {
+        return _buffer->getVulkanBuffer();
+    }
+
+    FrameRingBuffer::~FrameRingBuffer()
+    {
+        delete _buffer;
+    }
+
+    void FrameRingBuffer::reclaimRegion()
+    {
+        // Swapchain::updateDisplay waits for the render fence of the new image before starting a frame,
+        // so the region of that image is no longer read by the GPU
+
+        if (_frame == _swapchain.getFrameCount())
+            return;
+
+        _frame = _swapchain.getFrameCount();
+        _region = _swapchain.getCurrentImage();
+        _head = 0;
+    }
+}
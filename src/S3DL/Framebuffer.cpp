@@ -71,6 +71,7 @@ namespace s3dl
 
                 _attachments[i] = new Texture(_size, format, tiling, usage);
                 _attachmentsBelonging[i] = true;
+                _attachmentPins.push_back(_attachments[i]->pinVulkanImageView(imageAspects));
                 for (int j(0); j < swapchain._imageCount; j++)
                     _vulkanAttachments[j][i] = _attachments[i]->getVulkanImageView(imageAspects);
             }
@@ -0,0 +1,161 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const uint64_t GrowableBuffer::MIN_CAPACITY;
+
+    GrowableBuffer::GrowableBuffer(VkBufferUsageFlags usage, MemoryUsage memoryUsage, uint64_t capacity) :
+        _usage(usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT),
+        _memoryUsage(memoryUsage),
+        _buffer(nullptr),
+        _size(0),
+        _pendingCopyBatch(nullptr)
+    {
+        _buffer = new Buffer(std::max(capacity, MIN_CAPACITY), _usage, _memoryUsage);
+    }
+
+    uint64_t GrowableBuffer::append(const void* data, uint64_t size, TransferBatch* batch)
+    {
+        // Without a batch the growth copy and the write still share a single submit
+
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            uint64_t offset = append(data, size, &transferBatch);
+            transferBatch.submit();
+
+            if (_pendingCopyBatch == &transferBatch)
+                _pendingCopyBatch = nullptr;
+
+            return offset;
+        }
+
+        uint64_t offset = _size;
+        resize(_size + size, batch);
+        write(data, size, offset, batch);
+
+        return offset;
+    }
+
+    void GrowableBuffer::setData(const void* data, uint64_t size, uint64_t offset, TransferBatch* batch)
+    {
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            setData(data, size, offset, &transferBatch);
+            transferBatch.submit();
+
+            if (_pendingCopyBatch == &transferBatch)
+                _pendingCopyBatch = nullptr;
+
+            return;
+        }
+
+        if (offset + size > _size)
+            resize(offset + size, batch);
+
+        write(data, size, offset, batch);
+    }
+
+    void GrowableBuffer::getData(void* data, uint64_t size, uint64_t offset) const
+    {
+        if (offset + size > _size)
+            throw std::runtime_error("Cannot get " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes from growable buffer of size " + std::to_string(_size) + " bytes.");
+
+        _buffer->getData(data, size, offset);
+    }
+
+    void GrowableBuffer::reserve(uint64_t capacity, TransferBatch* batch)
+    {
+        if (capacity <= _buffer->getSize())
+            return;
+
+        // Grow geometrically so that appending stays amortized O(1)
+
+        uint64_t newCapacity = _buffer->getSize();
+        while (newCapacity < capacity)
+            newCapacity *= 2;
+
+        if (_size != 0 && batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            reserve(capacity, &transferBatch);
+            transferBatch.submit();
+
+            if (_pendingCopyBatch == &transferBatch)
+                _pendingCopyBatch = nullptr;
+
+            return;
+        }
+
+        Buffer* buffer = new Buffer(newCapacity, _usage, _memoryUsage);
+
+        if (_size != 0)
+        {
+            // The content is always copied on the GPU, the batch still has to read the old buffer so it is deleted once
+            // the batch is done
+
+            buffer->fillFromBuffer(*_buffer, _size, 0, 0, batch);
+            batch->retire(_buffer);
+            _buffer = buffer;
+            _pendingCopyBatch = batch;
+
+            return;
+        }
+
+        // Frames still in flight may read the old buffer, its destruction is deferred until they are done
+
+        delete _buffer;
+        _buffer = buffer;
+    }
+
+    void GrowableBuffer::resize(uint64_t size, TransferBatch* batch)
+    {
+        reserve(size, batch);
+        _size = size;
+    }
+
+    void GrowableBuffer::clear()
+    {
+        _size = 0;
+    }
+
+    uint64_t GrowableBuffer::getSize() const
+    {
+        return _size;
+    }
+
+    uint64_t GrowableBuffer::getCapacity() const
+    {
+        return _buffer->getSize();
+    }
+
+    const Buffer& GrowableBuffer::getBuffer() const
+    {
+        return *_buffer;
+    }
+
+    VkBuffer GrowableBuffer::getVulkanBuffer() const
+    {
+        return _buffer->getVulkanBuffer();
+    }
+
+    void GrowableBuffer::write(const void* data, uint64_t size, uint64_t offset, TransferBatch* batch)
+    {
+        // While the batch still has to copy the old content, a write made directly in mapped memory would be overwritten
+        // by that copy, so it is staged and copied after it instead
+
+        if (batch != nullptr && batch == _pendingCopyBatch)
+        {
+            std::pair<const Buffer*, uint64_t> staging = batch->stage(data, size);
+            _buffer->fillFromBuffer(*staging.first, size, staging.second, offset, batch);
+        }
+        else
+            _buffer->setData(data, size, offset, batch);
+    }
+
+    GrowableBuffer::~GrowableBuffer()
+    {
+        delete _buffer;
+    }
+}
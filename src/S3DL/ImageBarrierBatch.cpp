@@ -0,0 +1,128 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    void ImageBarrierBatch::getLayoutAccess(VkImageLayout layout, bool source, VkPipelineStageFlags& stage, VkAccessFlags& access)
+    {
+        // Only the stages and accesses that can use an image in the layout are waited for or made to wait
+
+        switch (layout)
+        {
+            case VK_IMAGE_LAYOUT_UNDEFINED:
+                stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                access = 0;
+                break;
+            case VK_IMAGE_LAYOUT_GENERAL:
+                stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+                access = source ? VK_ACCESS_MEMORY_WRITE_BIT : VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                access = source ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+                stage = source ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+                access = source ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+                stage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                access = source ? 0 : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                stage = source ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+                access = source ? 0 : VK_ACCESS_SHADER_READ_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                access = source ? 0 : VK_ACCESS_TRANSFER_READ_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                access = VK_ACCESS_TRANSFER_WRITE_BIT;
+                break;
+            case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+                stage = source ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                access = 0;
+                break;
+            default:
+                throw std::invalid_argument("Unsupported layout transition.");
+        }
+    }
+
+    ImageBarrierBatch::ImageBarrierBatch() :
+        _barriers(),
+        _srcStageMask(0),
+        _dstStageMask(0)
+    {
+    }
+
+    void ImageBarrierBatch::addTransition(VkImage image, const VkImageSubresourceRange& range, VkImageLayout oldLayout, VkImageLayout newLayout)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = range;
+
+        VkPipelineStageFlags sourceStage, destinationStage;
+        getLayoutAccess(oldLayout, true, sourceStage, barrier.srcAccessMask);
+        getLayoutAccess(newLayout, false, destinationStage, barrier.dstAccessMask);
+
+        _barriers.push_back(barrier);
+        _srcStageMask |= sourceStage;
+        _dstStageMask |= destinationStage;
+    }
+
+    bool ImageBarrierBatch::isEmpty() const
+    {
+        return _barriers.empty();
+    }
+
+    uint32_t ImageBarrierBatch::getBarrierCount() const
+    {
+        return _barriers.size();
+    }
+
+    void ImageBarrierBatch::record(VkCommandBuffer commandBuffer)
+    {
+        if (_barriers.empty())
+            return;
+
+        // Every transition of the batch in a single barrier command
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            _srcStageMask, _dstStageMask,
+            0,
+            0, nullptr,
+            0, nullptr,
+            _barriers.size(), _barriers.data()
+        );
+
+        _barriers.clear();
+        _srcStageMask = 0;
+        _dstStageMask = 0;
+    }
+
+    void ImageBarrierBatch::record(const Swapchain& swapchain)
+    {
+        record(swapchain.getCurrentCommandBuffer());
+    }
+
+    void ImageBarrierBatch::submit()
+    {
+        if (_barriers.empty())
+            return;
+
+        TransferBatch batch;
+        record(batch.getVulkanCommandBuffer());
+        batch.submit();
+    }
+
+    ImageBarrierBatch::~ImageBarrierBatch()
+    {
+    }
+}
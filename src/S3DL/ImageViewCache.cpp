@@ -0,0 +1,272 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    ImageViewCache::ImageViewCache(uint32_t capacity) :
+        _shards(),
+        _capacity(capacity),
+        _clock(0),
+        _hits(0),
+        _misses(0),
+        _evictions(0),
+        _liveViews(0)
+    {
+    }
+
+    VkImageView ImageViewCache::getView(VkImage image, VkFormat format, const TextureViewParameters& viewParameters)
+    {
+        Shard& shard = getShard(image);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        Entry& entry = getEntry(shard, {image, viewParameters});
+        entry.lastUse = _clock++;
+
+        if (entry.view != VK_NULL_HANDLE)
+        {
+            _hits++;
+            return entry.view;
+        }
+
+        _misses++;
+
+        entry.view = createView(image, format, viewParameters);
+        _liveViews++;
+
+        return entry.view;
+    }
+
+    ImageViewPinHandle ImageViewCache::pinView(VkImage image, const TextureViewParameters& viewParameters)
+    {
+        // A view can be pinned before it is created, it is then created on first use and never evicted
+
+        Shard& shard = getShard(image);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        return getEntry(shard, {image, viewParameters}).pin;
+    }
+
+    void ImageViewCache::prewarm(VkImage image, VkFormat format, const std::vector<TextureViewParameters>& viewParameters)
+    {
+        // Views of the same image are in the same shard, they are all created under a single lock
+
+        Shard& shard = getShard(image);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        for (const TextureViewParameters& parameters: viewParameters)
+        {
+            Entry& entry = getEntry(shard, {image, parameters});
+            entry.lastUse = _clock++;
+
+            if (entry.view == VK_NULL_HANDLE)
+            {
+                entry.view = createView(image, format, parameters);
+                _liveViews++;
+            }
+        }
+    }
+
+    void ImageViewCache::moveImage(VkImage oldImage, VkImage newImage, std::vector<VkImageView>& retiredViews)
+    {
+        // Views of the old image are retired, pins are kept so that the views recreated for the new image stay pinned
+
+        std::vector<std::pair<Key, Entry>> pinnedEntries;
+
+        {
+            Shard& shard = getShard(oldImage);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            std::unordered_map<Key, Entry, KeyHasher, KeyComparator>::iterator it = shard.entries.begin();
+            while (it != shard.entries.end())
+            {
+                if (it->first.image != oldImage)
+                {
+                    it++;
+                    continue;
+                }
+
+                if (it->second.view != VK_NULL_HANDLE)
+                {
+                    retiredViews.push_back(it->second.view);
+                    _liveViews--;
+                }
+
+                if (it->second.pin.use_count() > 1)
+                    pinnedEntries.push_back({{newImage, it->first.viewParameters}, {VK_NULL_HANDLE, it->second.pin, it->second.lastUse}});
+
+                it = shard.entries.erase(it);
+            }
+        }
+
+        Shard& shard = getShard(newImage);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        for (std::pair<Key, Entry>& entry: pinnedEntries)
+            shard.entries.insert(entry);
+    }
+
+    void ImageViewCache::releaseImage(VkImage image, std::vector<VkImageView>& retiredViews)
+    {
+        Shard& shard = getShard(image);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        std::unordered_map<Key, Entry, KeyHasher, KeyComparator>::iterator it = shard.entries.begin();
+        while (it != shard.entries.end())
+        {
+            if (it->first.image != image)
+            {
+                it++;
+                continue;
+            }
+
+            if (it->second.view != VK_NULL_HANDLE)
+            {
+                retiredViews.push_back(it->second.view);
+                _liveViews--;
+            }
+
+            it = shard.entries.erase(it);
+        }
+    }
+
+    void ImageViewCache::setCapacity(uint32_t capacity)
+    {
+        _capacity = capacity;
+    }
+
+    void ImageViewCache::evict()
+    {
+        uint32_t liveViews = _liveViews;
+        uint32_t capacity = _capacity;
+        if (liveViews <= capacity)
+            return;
+
+        // Least recently used views first, among the ones no descriptor or framebuffer pinned
+
+        std::vector<Key> candidates;
+        std::vector<std::pair<uint64_t, uint32_t>> order;
+        for (Shard& shard: _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            for (const std::pair<const Key, Entry>& entry: shard.entries)
+            {
+                if (entry.second.view != VK_NULL_HANDLE && entry.second.pin.use_count() == 1)
+                {
+                    order.push_back({entry.second.lastUse, candidates.size()});
+                    candidates.push_back(entry.first);
+                }
+            }
+        }
+
+        std::sort(order.begin(), order.end());
+
+        RetiredResource retiredResource{};
+
+        for (uint32_t i = 0; i < order.size() && retiredResource.imageViews.size() < liveViews - capacity; i++)
+        {
+            const Key& key = candidates[order[i].second];
+            Shard& shard = getShard(key.image);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            // The view may have been used or pinned since the candidates were gathered
+
+            std::unordered_map<Key, Entry, KeyHasher, KeyComparator>::iterator it = shard.entries.find(key);
+            if (it == shard.entries.end() || it->second.lastUse != order[i].first || it->second.pin.use_count() != 1)
+                continue;
+
+            retiredResource.imageViews.push_back(it->second.view);
+            shard.entries.erase(it);
+
+            _liveViews--;
+            _evictions++;
+        }
+
+        // Frames in flight may still use the views, they are destroyed once they are done
+
+        if (!retiredResource.imageViews.empty())
+            Device::Active->getDeletionQueue()->enqueue(retiredResource);
+    }
+
+    ImageViewCacheStatistics ImageViewCache::getStatistics() const
+    {
+        ImageViewCacheStatistics statistics{};
+        statistics.hits = _hits;
+        statistics.misses = _misses;
+        statistics.evictions = _evictions;
+        statistics.liveViews = _liveViews;
+
+        for (const Shard& shard: _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            for (const std::pair<const Key, Entry>& entry: shard.entries)
+                if (entry.second.view != VK_NULL_HANDLE && entry.second.pin.use_count() > 1)
+                    statistics.pinnedViews++;
+        }
+
+        return statistics;
+    }
+
+    ImageViewCache::~ImageViewCache()
+    {
+        RetiredResource retiredResource{};
+        for (Shard& shard: _shards)
+            for (std::pair<const Key, Entry>& entry: shard.entries)
+                if (entry.second.view != VK_NULL_HANDLE)
+                    retiredResource.imageViews.push_back(entry.second.view);
+
+        if (!retiredResource.imageViews.empty())
+            Device::Active->getDeletionQueue()->enqueue(retiredResource);
+    }
+
+    std::size_t ImageViewCache::KeyHasher::operator()(const Key& x) const
+    {
+        std::size_t seed = TextureViewParameters::Hasher()(x.viewParameters);
+        boost::hash_combine(seed, x.image);
+
+        return seed;
+    }
+
+    bool ImageViewCache::KeyComparator::operator()(const Key& x, const Key& y) const
+    {
+        return x.image == y.image && TextureViewParameters::Comparator()(x.viewParameters, y.viewParameters);
+    }
+
+    VkImageView ImageViewCache::createView(VkImage image, VkFormat format, const TextureViewParameters& viewParameters)
+    {
+        VkImageViewCreateInfo createInfo = viewParameters.getVulkanImageViewCreateInfo();
+        VkImageView view(VK_NULL_HANDLE);
+
+        createInfo.image = image;
+        createInfo.format = format;
+
+        VkResult result = vkCreateImageView(Device::Active->getVulkanDevice(), &createInfo, nullptr, &view);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create texture image view. VkResult: " + std::to_string(result));
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkImageView successfully created." << std::endl;
+        #endif
+
+        return view;
+    }
+
+    ImageViewCache::Shard& ImageViewCache::getShard(VkImage image)
+    {
+        // Every view of an image lives in the same shard, so that the image can be moved or released under one lock
+
+        std::size_t seed = 0;
+        boost::hash_combine(seed, image);
+
+        return _shards[seed % SHARD_COUNT];
+    }
+
+    ImageViewCache::Entry& ImageViewCache::getEntry(Shard& shard, const Key& key)
+    {
+        std::unordered_map<Key, Entry, KeyHasher, KeyComparator>::iterator it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            it = shard.entries.insert({key, {VK_NULL_HANDLE, std::make_shared<const ImageViewPin>(), 0}}).first;
+
+        return it->second;
+    }
+}
@@ -0,0 +1,582 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const VkDeviceSize MemoryAllocator::BLOCK_SIZE;
+
+    MemoryAllocator::MemoryAllocator(const PhysicalDevice& physicalDevice, VkDevice device, bool memoryBudgetSupported) :
+        _physicalDevice(physicalDevice.getVulkanPhysicalDevice()),
+        _device(device),
+        _memoryProperties(physicalDevice.memoryProperties),
+        _bufferImageGranularity(physicalDevice.properties.limits.bufferImageGranularity),
+        _nonCoherentAtomSize(std::max<VkDeviceSize>(physicalDevice.properties.limits.nonCoherentAtomSize, 1))
+    {
+        _pools.resize(2 * _memoryProperties.memoryTypeCount);
+
+        _memoryBudgetSupported = memoryBudgetSupported;
+        _heapBudgets.resize(_memoryProperties.memoryHeapCount, MemoryHeapBudget{});
+        for (uint32_t i = 0; i < _memoryProperties.memoryHeapCount; i++)
+            _heapBudgets[i].heapSize = _memoryProperties.memoryHeaps[i].size;
+
+        _relocationCount = 0;
+    }
+
+    void MemoryAllocator::getMemoryUsageFlags(MemoryUsage usage, VkMemoryPropertyFlags& requiredFlags, VkMemoryPropertyFlags& preferredFlags)
+    {
+        switch (usage)
+        {
+            case MemoryUsage::GpuOnly:
+                requiredFlags = 0;
+                preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                return;
+            case MemoryUsage::Upload:
+                requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+                preferredFlags = 0;
+                return;
+            case MemoryUsage::Readback:
+                requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+                preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+                return;
+            case MemoryUsage::Dynamic:
+                requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+                preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                return;
+        }
+
+        throw std::runtime_error("Unknown memory usage.");
+    }
+
+    uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, MemoryUsage usage) const
+    {
+        VkMemoryPropertyFlags requiredFlags, preferredFlags;
+        getMemoryUsageFlags(usage, requiredFlags, preferredFlags);
+
+        return findMemoryType(typeFilter, requiredFlags, preferredFlags);
+    }
+
+    uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags requiredFlags, VkMemoryPropertyFlags preferredFlags) const
+    {
+        // Rank the compatible types by preferred flags, then heap size, then host access so that
+        // device local memory that is also mappable (UMA, resizable BAR) wins when it is as large
+
+        const VkMemoryPropertyFlags unwantedFlags = (VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_PROTECTED_BIT) & ~requiredFlags;
+        const VkMemoryPropertyFlags hostAccessFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        uint32_t bestType = UINT32_MAX;
+        std::tuple<uint32_t, VkDeviceSize, uint32_t> bestScore;
+
+        for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++)
+        {
+            VkMemoryPropertyFlags flags = _memoryProperties.memoryTypes[i].propertyFlags;
+
+            if (!(typeFilter & (1 << i)) || (flags & requiredFlags) != requiredFlags || (flags & unwantedFlags))
+                continue;
+
+            std::tuple<uint32_t, VkDeviceSize, uint32_t> score(
+                countBits(flags & preferredFlags),
+                _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[i].heapIndex].size,
+                countBits(flags & hostAccessFlags)
+            );
+
+            if (bestType == UINT32_MAX || score > bestScore)
+            {
+                bestType = i;
+                bestScore = score;
+            }
+        }
+
+        if (bestType == UINT32_MAX)
+            throw std::runtime_error("Failed to find suitable memory type.");
+
+        return bestType;
+    }
+
+    VkMemoryPropertyFlags MemoryAllocator::getMemoryTypeFlags(uint32_t memoryType) const
+    {
+        return _memoryProperties.memoryTypes[memoryType].propertyFlags;
+    }
+
+    MemoryAllocation MemoryAllocator::allocate(const VkMemoryRequirements& memoryRequirements, uint32_t memoryType, bool linear, MemoryCategory category, MemoryResource* resource)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryAllocation allocation{};
+
+        // Non-coherent allocations must not share an atom with their neighbours, or flushing one would clobber the other
+
+        VkMemoryRequirements requirements = memoryRequirements;
+        if (isNonCoherent(memoryType))
+        {
+            requirements.alignment = std::max(requirements.alignment, _nonCoherentAtomSize);
+            requirements.size = (requirements.size + _nonCoherentAtomSize - 1) / _nonCoherentAtomSize * _nonCoherentAtomSize;
+        }
+
+        std::vector<MemoryBlock*>& pool = _pools[getPoolIndex(memoryType, linear)];
+        VkDeviceSize blockSize = getBlockSize(memoryType);
+
+        // Big resources get their own block to avoid wasting the end of shared blocks
+
+        if (requiresDedicatedBlock(requirements.size, blockSize))
+        {
+            MemoryBlock* block = createBlock(memoryType, requirements.size, true);
+            allocateFromBlock(block, requirements, allocation);
+            pool.push_back(block);
+        }
+        else
+        {
+            // Try to sub-allocate from existing blocks, except the one being defragmented, otherwise reserve a new block
+
+            bool allocated = false;
+            for (MemoryBlock* block: pool)
+            {
+                if (!block->dedicated && !block->evacuating && allocateFromBlock(block, requirements, allocation))
+                {
+                    allocated = true;
+                    break;
+                }
+            }
+
+            if (!allocated)
+            {
+                MemoryBlock* block = createBlock(memoryType, blockSize, false);
+                allocateFromBlock(block, requirements, allocation);
+                pool.push_back(block);
+            }
+        }
+
+        allocation.category = category;
+        trackAllocation(allocation);
+
+        if (resource != nullptr)
+            allocation.block->resources[allocation.offset] = resource;
+
+        return allocation;
+    }
+
+    void MemoryAllocator::free(const MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryBlock* block = allocation.block;
+        if (block == nullptr)
+            return;
+
+        freeFromBlock(block, allocation);
+        trackFree(allocation);
+
+        // Release empty blocks, but keep the last shared block of each pool to avoid reallocation churn
+
+        if (block->allocationCount == 0)
+        {
+            for (std::vector<MemoryBlock*>& pool: _pools)
+            {
+                std::vector<MemoryBlock*>::iterator it = std::find(pool.begin(), pool.end(), block);
+                if (it == pool.end())
+                    continue;
+
+                uint32_t sharedBlockCount = 0;
+                for (const MemoryBlock* other: pool)
+                    if (!other->dedicated)
+                        sharedBlockCount++;
+
+                if (block->dedicated || sharedBlockCount > 1)
+                {
+                    pool.erase(it);
+                    destroyBlock(block);
+                }
+
+                break;
+            }
+        }
+    }
+
+    void MemoryAllocator::detachResource(const MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        allocation.block->resources.erase(allocation.offset);
+    }
+
+    void* MemoryAllocator::map(const MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryBlock* block = allocation.block;
+
+        if (block->mapCount == 0)
+        {
+            VkResult result = vkMapMemory(_device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to map device memory block. VkResult: " + std::to_string(result));
+        }
+
+        block->mapCount++;
+
+        return static_cast<uint8_t*>(block->mapped) + allocation.offset;
+    }
+
+    void MemoryAllocator::unmap(const MemoryAllocation& allocation)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryBlock* block = allocation.block;
+
+        if (block->mapCount == 0)
+            return;
+
+        block->mapCount--;
+        if (block->mapCount == 0)
+        {
+            vkUnmapMemory(_device, block->memory);
+            block->mapped = nullptr;
+        }
+    }
+
+    void MemoryAllocator::flush(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+    {
+        if (!isNonCoherent(allocation.memoryType))
+            return;
+
+        VkMappedMemoryRange range = getMappedRange(allocation, offset, size);
+        VkResult result = vkFlushMappedMemoryRanges(_device, 1, &range);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to flush mapped memory range. VkResult: " + std::to_string(result));
+    }
+
+    void MemoryAllocator::invalidate(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+    {
+        if (!isNonCoherent(allocation.memoryType))
+            return;
+
+        VkMappedMemoryRange range = getMappedRange(allocation, offset, size);
+        VkResult result = vkInvalidateMappedMemoryRanges(_device, 1, &range);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to invalidate mapped memory range. VkResult: " + std::to_string(result));
+    }
+
+    MemoryStatistics MemoryAllocator::getStatistics() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryStatistics statistics{};
+        VkDeviceSize freeBytes = 0;
+
+        for (const std::vector<MemoryBlock*>& pool: _pools)
+            for (const MemoryBlock* block: pool)
+                accumulateStatistics(block, statistics, freeBytes);
+
+        if (freeBytes != 0)
+            statistics.fragmentation = 1.f - static_cast<float>(statistics.largestFreeRange) / freeBytes;
+
+        return statistics;
+    }
+
+    MemoryStatistics MemoryAllocator::getStatistics(uint32_t memoryType) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        MemoryStatistics statistics{};
+        VkDeviceSize freeBytes = 0;
+
+        for (uint32_t linear = 0; linear < 2; linear++)
+            for (const MemoryBlock* block: _pools[2 * memoryType + linear])
+                accumulateStatistics(block, statistics, freeBytes);
+
+        if (freeBytes != 0)
+            statistics.fragmentation = 1.f - static_cast<float>(statistics.largestFreeRange) / freeBytes;
+
+        return statistics;
+    }
+
+    bool MemoryAllocator::isMemoryBudgetSupported() const
+    {
+        return _memoryBudgetSupported;
+    }
+
+    MemoryHeapBudget MemoryAllocator::getHeapBudget(uint32_t heapIndex) const
+    {
+        if (heapIndex >= _memoryProperties.memoryHeapCount)
+            throw std::range_error("Cannot access budget of heap " + std::to_string(heapIndex) + " of device of " + std::to_string(_memoryProperties.memoryHeapCount) + " memory heaps.");
+
+        return getHeapBudgets()[heapIndex];
+    }
+
+    std::vector<MemoryHeapBudget> MemoryAllocator::getHeapBudgets() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        std::vector<MemoryHeapBudget> budgets(_heapBudgets);
+
+        if (_memoryBudgetSupported)
+        {
+            // The driver budget also accounts for other processes and for memory not allocated by S3DL
+
+            VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+            budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+            VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+            memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+            memoryProperties.pNext = &budgetProperties;
+
+            vkGetPhysicalDeviceMemoryProperties2(_physicalDevice, &memoryProperties);
+
+            for (uint32_t i = 0; i < budgets.size(); i++)
+            {
+                budgets[i].budget = budgetProperties.heapBudget[i];
+                budgets[i].usage = budgetProperties.heapUsage[i];
+            }
+        }
+        else
+        {
+            // Without the extension, assume 80% of each heap is usable and that S3DL is its only user
+
+            for (MemoryHeapBudget& budget: budgets)
+            {
+                budget.budget = budget.heapSize / 10 * 8;
+                budget.usage = budget.blockBytes;
+            }
+        }
+
+        return budgets;
+    }
+
+    uint64_t MemoryAllocator::getRelocationCount() const
+    {
+        return _relocationCount;
+    }
+
+    MemoryAllocator::~MemoryAllocator()
+    {
+        for (std::vector<MemoryBlock*>& pool: _pools)
+        {
+            for (MemoryBlock* block: pool)
+            {
+                #ifndef NDEBUG
+                if (block->allocationCount != 0)
+                    std::clog << "<S3DL Debug> Device memory block destroyed with " + std::to_string(block->allocationCount) + " allocations still alive." << std::endl;
+                #endif
+
+                destroyBlock(block);
+            }
+        }
+    }
+
+    uint32_t MemoryAllocator::getPoolIndex(uint32_t memoryType, bool linear) const
+    {
+        // Linear and optimal resources only need distinct blocks when the granularity is coarser than a byte
+
+        if (_bufferImageGranularity > 1 && linear)
+            return 2 * memoryType + 1;
+
+        return 2 * memoryType;
+    }
+
+    VkDeviceSize MemoryAllocator::getBlockSize(uint32_t memoryType) const
+    {
+        VkDeviceSize heapSize = _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[memoryType].heapIndex].size;
+
+        return std::min(BLOCK_SIZE, heapSize / 8);
+    }
+
+    void MemoryAllocator::trackAllocation(const MemoryAllocation& allocation)
+    {
+        MemoryHeapBudget& budget = _heapBudgets[_memoryProperties.memoryTypes[allocation.memoryType].heapIndex];
+        MemoryCategoryUsage& category = budget.categories[static_cast<uint32_t>(allocation.category)];
+
+        budget.allocatedBytes += allocation.size;
+        budget.peakAllocatedBytes = std::max(budget.peakAllocatedBytes, budget.allocatedBytes);
+        budget.allocationCount++;
+
+        category.bytes += allocation.size;
+        category.peakBytes = std::max(category.peakBytes, category.bytes);
+        category.allocationCount++;
+    }
+
+    void MemoryAllocator::trackFree(const MemoryAllocation& allocation)
+    {
+        MemoryHeapBudget& budget = _heapBudgets[_memoryProperties.memoryTypes[allocation.memoryType].heapIndex];
+        MemoryCategoryUsage& category = budget.categories[static_cast<uint32_t>(allocation.category)];
+
+        budget.allocatedBytes -= allocation.size;
+        budget.allocationCount--;
+
+        category.bytes -= allocation.size;
+        category.allocationCount--;
+    }
+
+    bool MemoryAllocator::isNonCoherent(uint32_t memoryType) const
+    {
+        VkMemoryPropertyFlags flags = _memoryProperties.memoryTypes[memoryType].propertyFlags;
+
+        return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    VkMappedMemoryRange MemoryAllocator::getMappedRange(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+    {
+        if (allocation.block == nullptr || allocation.block->mapCount == 0)
+            throw std::runtime_error("Cannot flush or invalidate memory that is not mapped.");
+
+        if (size == VK_WHOLE_SIZE)
+            size = allocation.size - std::min(offset, allocation.size);
+
+        // Widen the range to whole atoms, which stay inside the allocation since it is itself atom aligned
+
+        VkDeviceSize begin = (allocation.offset + offset) / _nonCoherentAtomSize * _nonCoherentAtomSize;
+        VkDeviceSize end = (allocation.offset + offset + size + _nonCoherentAtomSize - 1) / _nonCoherentAtomSize * _nonCoherentAtomSize;
+
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = allocation.memory;
+        range.offset = begin;
+        range.size = (end >= allocation.block->size) ? VK_WHOLE_SIZE : end - begin;
+
+        return range;
+    }
+
+    MemoryBlock* MemoryAllocator::createBlock(uint32_t memoryType, VkDeviceSize size, bool dedicated)
+    {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        VkDeviceMemory memory;
+        VkResult result = vkAllocateMemory(_device, &allocInfo, nullptr, &memory);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate device memory block. VkResult: " + std::to_string(result));
+
+        MemoryBlock* block = new MemoryBlock();
+        block->memory = memory;
+        block->size = size;
+        block->memoryType = memoryType;
+        block->dedicated = dedicated;
+        block->freeRanges[0] = size;
+        block->allocationCount = 0;
+        block->bytesInUse = 0;
+        block->mapped = nullptr;
+        block->mapCount = 0;
+        block->evacuating = false;
+
+        _heapBudgets[_memoryProperties.memoryTypes[memoryType].heapIndex].blockBytes += size;
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> Device memory block of " + std::to_string(size) + " bytes successfully allocated in memory type " + std::to_string(memoryType) + "." << std::endl;
+        #endif
+
+        return block;
+    }
+
+    void MemoryAllocator::destroyBlock(MemoryBlock* block)
+    {
+        if (block->mapCount != 0)
+            vkUnmapMemory(_device, block->memory);
+
+        vkFreeMemory(_device, block->memory, nullptr);
+
+        _heapBudgets[_memoryProperties.memoryTypes[block->memoryType].heapIndex].blockBytes -= block->size;
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> Device memory block of " + std::to_string(block->size) + " bytes successfully freed." << std::endl;
+        #endif
+
+        delete block;
+    }
+
+    uint32_t MemoryAllocator::countBits(uint32_t value)
+    {
+        uint32_t count = 0;
+        for (; value != 0; value &= value - 1)
+            count++;
+
+        return count;
+    }
+
+    bool MemoryAllocator::requiresDedicatedBlock(VkDeviceSize size, VkDeviceSize blockSize)
+    {
+        return size > blockSize / 2;
+    }
+
+    bool MemoryAllocator::allocateFromBlock(MemoryBlock* block, const VkMemoryRequirements& requirements, MemoryAllocation& allocation)
+    {
+        VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+        for (std::map<VkDeviceSize, VkDeviceSize>::iterator it = block->freeRanges.begin(); it != block->freeRanges.end(); it++)
+        {
+            VkDeviceSize rangeOffset = it->first;
+            VkDeviceSize rangeSize = it->second;
+            VkDeviceSize offset = (rangeOffset + alignment - 1) / alignment * alignment;
+
+            if (offset + requirements.size > rangeOffset + rangeSize)
+                continue;
+
+            // Split the free range around the new allocation
+
+            block->freeRanges.erase(it);
+            if (offset > rangeOffset)
+                block->freeRanges[rangeOffset] = offset - rangeOffset;
+            if (offset + requirements.size < rangeOffset + rangeSize)
+                block->freeRanges[offset + requirements.size] = rangeOffset + rangeSize - offset - requirements.size;
+
+            block->allocationCount++;
+            block->bytesInUse += requirements.size;
+
+            allocation.block = block;
+            allocation.memory = block->memory;
+            allocation.offset = offset;
+            allocation.size = requirements.size;
+            allocation.memoryType = block->memoryType;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void MemoryAllocator::freeFromBlock(MemoryBlock* block, const MemoryAllocation& allocation)
+    {
+        // Give the range back and merge it with its free neighbours
+
+        VkDeviceSize offset = allocation.offset;
+        VkDeviceSize size = allocation.size;
+
+        std::map<VkDeviceSize, VkDeviceSize>::iterator next = block->freeRanges.lower_bound(offset);
+        if (next != block->freeRanges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            next = block->freeRanges.erase(next);
+        }
+
+        if (next != block->freeRanges.begin())
+        {
+            std::map<VkDeviceSize, VkDeviceSize>::iterator previous = std::prev(next);
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                size += previous->second;
+                block->freeRanges.erase(previous);
+            }
+        }
+
+        block->resources.erase(allocation.offset);
+
+        block->freeRanges[offset] = size;
+        block->allocationCount--;
+        block->bytesInUse -= allocation.size;
+    }
+
+    void MemoryAllocator::accumulateStatistics(const MemoryBlock* block, MemoryStatistics& statistics, VkDeviceSize& freeBytes)
+    {
+        statistics.blockCount++;
+        if (block->dedicated)
+            statistics.dedicatedBlockCount++;
+        statistics.allocationCount += block->allocationCount;
+        statistics.bytesReserved += block->size;
+        statistics.bytesInUse += block->bytesInUse;
+
+        for (const std::pair<const VkDeviceSize, VkDeviceSize>& range: block->freeRanges)
+        {
+            freeBytes += range.second;
+            statistics.largestFreeRange = std::max(statistics.largestFreeRange, range.second);
+        }
+    }
+}
@@ -0,0 +1,199 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const VkDeviceSize MemoryDefragmenter::DEFAULT_BYTES_PER_PASS;
+
+    MemoryDefragmenter::MemoryDefragmenter(const Swapchain& swapchain, VkDeviceSize bytesPerPass) :
+        _swapchain(swapchain),
+        _bytesPerPass(bytesPerPass),
+        _totalStatistics{}
+    {
+    }
+
+    DefragmentationStatistics MemoryDefragmenter::defragment()
+    {
+        VkResult result;
+        MemoryAllocator* allocator = Device::Active->getMemoryAllocator();
+        DefragmentationStatistics statistics{};
+
+        // Other threads must not allocate or free while blocks are inspected and evacuated
+
+        std::lock_guard<std::recursive_mutex> lock(allocator->_mutex);
+
+        // Destroy what previous passes moved away once the frames using it are done, which releases emptied blocks
+
+        MemoryStatistics statisticsBefore = allocator->getStatistics();
+        Device::Active->getDeletionQueue()->collect();
+        MemoryStatistics statisticsAfter = allocator->getStatistics();
+
+        statistics.blocksReleased = statisticsBefore.blockCount - statisticsAfter.blockCount;
+        statistics.bytesReleased = statisticsBefore.bytesReserved - statisticsAfter.bytesReserved;
+
+        // Evacuate the emptiest shared block into the free space of the others
+
+        MemoryBlock* block = findEvacuationCandidate();
+        if (block != nullptr)
+        {
+            VkCommandBuffer commandBuffer = Device::Active->acquireTransientCommandBuffer();
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to start recording command buffer for memory defragmentation. VkResult: " + std::to_string(result));
+
+            // Frames in flight may still write the resources, make the copies wait for them
+
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+            // Move resources until the budget of the pass is spent, the allocator skips the evacuated block meanwhile
+
+            std::vector<std::pair<VkDeviceSize, MemoryResource*>> resources(block->resources.begin(), block->resources.end());
+
+            block->evacuating = true;
+            for (std::pair<VkDeviceSize, MemoryResource*>& resource: resources)
+            {
+                if (statistics.bytesMoved >= _bytesPerPass)
+                    break;
+
+                if (!resource.second->isRelocatable())
+                    continue;
+
+                RetiredResource retiredResource{};
+                resource.second->relocate(commandBuffer, retiredResource);
+
+                block->resources.erase(resource.first);
+
+                statistics.allocationsMoved++;
+                statistics.bytesMoved += retiredResource.allocation.size;
+
+                Device::Active->getDeletionQueue()->enqueue(retiredResource);
+            }
+            block->evacuating = false;
+
+            // Make the copies visible to everything submitted afterwards
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+            result = vkEndCommandBuffer(commandBuffer);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to end recording command buffer for memory defragmentation. VkResult: " + std::to_string(result));
+
+            // Submit the copies and wait for them
+
+            VkFence transferFence = Device::Active->getSyncObjectPool()->acquireFence();
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+
+            result = Device::Active->submit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
+            if (result != VK_SUCCESS)
+            {
+                Device::Active->releaseTransientCommandBuffer(commandBuffer);
+                Device::Active->getSyncObjectPool()->releaseFence(transferFence);
+
+                throw std::runtime_error("Failed to submit memory defragmentation command buffer. VkResult: " + std::to_string(result));
+            }
+
+            result = vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to wait for memory defragmentation. VkResult: " + std::to_string(result));
+
+            Device::Active->releaseTransientCommandBuffer(commandBuffer);
+            Device::Active->getSyncObjectPool()->releaseFence(transferFence);
+
+            // Descriptors and views referring to the moved resources must be rewritten
+
+            if (statistics.allocationsMoved != 0)
+                allocator->_relocationCount++;
+        }
+
+        _totalStatistics.allocationsMoved += statistics.allocationsMoved;
+        _totalStatistics.bytesMoved += statistics.bytesMoved;
+        _totalStatistics.blocksReleased += statistics.blocksReleased;
+        _totalStatistics.bytesReleased += statistics.bytesReleased;
+
+        #ifndef NDEBUG
+        if (statistics.allocationsMoved != 0 || statistics.blocksReleased != 0)
+            std::clog << "<S3DL Debug> Defragmentation pass moved " + std::to_string(statistics.bytesMoved) + " bytes in " + std::to_string(statistics.allocationsMoved) + " allocations and released " + std::to_string(statistics.bytesReleased) + " bytes in " + std::to_string(statistics.blocksReleased) + " blocks." << std::endl;
+        #endif
+
+        return statistics;
+    }
+
+    void MemoryDefragmenter::setBytesPerPass(VkDeviceSize bytesPerPass)
+    {
+        _bytesPerPass = bytesPerPass;
+    }
+
+    VkDeviceSize MemoryDefragmenter::getBytesPerPass() const
+    {
+        return _bytesPerPass;
+    }
+
+    const DefragmentationStatistics& MemoryDefragmenter::getTotalStatistics() const
+    {
+        return _totalStatistics;
+    }
+
+    MemoryBlock* MemoryDefragmenter::findEvacuationCandidate() const
+    {
+        MemoryAllocator* allocator = Device::Active->getMemoryAllocator();
+        MemoryBlock* candidate = nullptr;
+
+        for (const std::vector<MemoryBlock*>& pool: allocator->_pools)
+        {
+            // Only shared blocks are worth compacting, and only when the others can absorb their content
+
+            uint32_t sharedBlockCount = 0;
+            VkDeviceSize freeBytes = 0;
+            for (const MemoryBlock* block: pool)
+            {
+                if (!block->dedicated)
+                {
+                    sharedBlockCount++;
+                    freeBytes += block->size - block->bytesInUse;
+                }
+            }
+
+            if (sharedBlockCount < 2)
+                continue;
+
+            for (MemoryBlock* block: pool)
+            {
+                if (block->dedicated || block->bytesInUse > freeBytes - (block->size - block->bytesInUse))
+                    continue;
+                if (candidate != nullptr && static_cast<float>(block->bytesInUse) / block->size >= static_cast<float>(candidate->bytesInUse) / candidate->size)
+                    continue;
+
+                bool relocatable = false;
+                for (const std::pair<const VkDeviceSize, MemoryResource*>& resource: block->resources)
+                {
+                    if (resource.second->isRelocatable())
+                    {
+                        relocatable = true;
+                        break;
+                    }
+                }
+
+                if (relocatable)
+                    candidate = block;
+            }
+        }
+
+        return candidate;
+    }
+}
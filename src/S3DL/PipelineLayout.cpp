@@ -94,6 +94,35 @@ namespace s3dl
         _globalBindings[i].offset = 0;
     }
 
+    void PipelineLayout::declareGlobalStorageBuffer(uint32_t binding, VkShaderStageFlags shaderStage)
+    {
+        if (_locked)
+            throw std::runtime_error("Cannot declare storage buffer while pipeline layout is locked.");
+        
+        int i(0);
+        for (; i < _globalBindingsLayouts.size(); i++)
+            if (_globalBindingsLayouts[i].binding == binding)
+                break;
+        
+        if (i == _globalBindingsLayouts.size())
+        {
+            VkDescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.binding = binding;
+
+            _globalBindingsLayouts.push_back(layoutBinding);
+            _globalBindings.push_back(DescriptorSetLayoutBindingState{});
+        }
+
+        _globalBindingsLayouts[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        _globalBindingsLayouts[i].descriptorCount = 1;
+        _globalBindingsLayouts[i].stageFlags = shaderStage;
+        _globalBindingsLayouts[i].pImmutableSamplers = nullptr;
+        
+        _globalBindings[i].size = 0;
+        _globalBindings[i].count = 1;
+        _globalBindings[i].offset = 0;
+    }
+
     void PipelineLayout::declareDrawablesUniform(uint32_t binding, uint32_t size, VkShaderStageFlags shaderStage)
     {
         declareDrawablesUniformArray(binding, size, 1, shaderStage);
@@ -186,6 +215,35 @@ namespace s3dl
         _drawablesBindings[i].offset = 0;
     }
 
+    void PipelineLayout::declareDrawablesStorageBuffer(uint32_t binding, VkShaderStageFlags shaderStage)
+    {
+        if (_locked)
+            throw std::runtime_error("Cannot declare storage buffer while pipeline layout is locked.");
+        
+        int i(0);
+        for (; i < _drawablesBindingsLayouts.size(); i++)
+            if (_drawablesBindingsLayouts[i].binding == binding)
+                break;
+        
+        if (i == _drawablesBindingsLayouts.size())
+        {
+            VkDescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.binding = binding;
+
+            _drawablesBindingsLayouts.push_back(layoutBinding);
+            _drawablesBindings.push_back(DescriptorSetLayoutBindingState{});
+        }
+
+        _drawablesBindingsLayouts[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        _drawablesBindingsLayouts[i].descriptorCount = 1;
+        _drawablesBindingsLayouts[i].stageFlags = shaderStage;
+        _drawablesBindingsLayouts[i].pImmutableSamplers = nullptr;
+        
+        _drawablesBindings[i].size = 0;
+        _drawablesBindings[i].count = 1;
+        _drawablesBindings[i].offset = 0;
+    }
+
     void PipelineLayout::lock(const Swapchain& swapchain)
     {
         _swapchainImageCount = swapchain.getImageCount();
@@ -233,6 +291,7 @@ namespace s3dl
         if (!_locked)
             throw std::runtime_error("Cannot set uniform value while pipeline layout is not locked.");
 
+        _globalResources[binding] = {&texture, nullptr, {0, 1}, nullptr, texture.pinVulkanImageView(getDescriptorViewParameters(texture.getFormat()))};
         _globalSamplers[binding] = {texture.getVulkanImageView(getDescriptorViewParameters(texture.getFormat())), texture.getVulkanSampler()};
 
         for (int i(0); i < _swapchainImageCount; i++)
@@ -244,18 +303,32 @@ namespace s3dl
         if (!_locked)
             throw std::runtime_error("Cannot set uniform value while pipeline layout is not locked.");
 
+        _globalResources[binding] = {nullptr, &textureArray, layerRange, nullptr, textureArray.pinVulkanImageView(getDescriptorViewParameters(textureArray.getFormat(), layerRange))};
         _globalSamplers[binding] = {textureArray.getVulkanImageView(getDescriptorViewParameters(textureArray.getFormat(), layerRange)), textureArray.getVulkanSampler()};
 
         for (int i(0); i < _swapchainImageCount; i++)
             _globalNeedsUpdate[binding][i] = true;
     }
 
+    void PipelineLayout::setGlobalStorageBuffer(uint32_t binding, const Buffer& buffer, uint64_t offset, uint64_t range)
+    {
+        if (!_locked)
+            throw std::runtime_error("Cannot set storage buffer while pipeline layout is not locked.");
+
+        _globalStorageBuffers[binding] = {buffer.getVulkanBuffer(), offset, range};
+        _globalResources[binding] = {nullptr, nullptr, {0, 1}, &buffer, nullptr};
+
+        for (int i(0); i < _swapchainImageCount; i++)
+            _globalNeedsUpdate[binding][i] = true;
+    }
+
     void PipelineLayout::setDrawablesUniformSampler(const Drawable& drawable, uint32_t binding, const Texture& texture)
     {
         if (!_locked)
             throw std::runtime_error("Cannot set uniform value while pipeline layout is not locked.");
 
         addDrawable(drawable);
+        _drawablesResources[&drawable][binding] = {&texture, nullptr, {0, 1}, nullptr, texture.pinVulkanImageView(getDescriptorViewParameters(texture.getFormat()))};
         _drawablesSamplers[&drawable][binding] = {texture.getVulkanImageView(getDescriptorViewParameters(texture.getFormat())), texture.getVulkanSampler()};
 
         for (int i(0); i < _swapchainImageCount; i++)
@@ -268,12 +341,26 @@ namespace s3dl
             throw std::runtime_error("Cannot set uniform value while pipeline layout is not locked.");
 
         addDrawable(drawable);
+        _drawablesResources[&drawable][binding] = {nullptr, &textureArray, layerRange, nullptr, textureArray.pinVulkanImageView(getDescriptorViewParameters(textureArray.getFormat(), layerRange))};
         _drawablesSamplers[&drawable][binding] = {textureArray.getVulkanImageView(getDescriptorViewParameters(textureArray.getFormat(), layerRange)), textureArray.getVulkanSampler()};
 
         for (int i(0); i < _swapchainImageCount; i++)
             _drawablesNeedsUpdate[binding][&drawable][i] = true;
     }
 
+    void PipelineLayout::setDrawablesStorageBuffer(const Drawable& drawable, uint32_t binding, const Buffer& buffer, uint64_t offset, uint64_t range)
+    {
+        if (!_locked)
+            throw std::runtime_error("Cannot set storage buffer while pipeline layout is not locked.");
+
+        addDrawable(drawable);
+        _drawablesStorageBuffers[&drawable][binding] = {buffer.getVulkanBuffer(), offset, range};
+        _drawablesResources[&drawable][binding] = {nullptr, nullptr, {0, 1}, &buffer, nullptr};
+
+        for (int i(0); i < _swapchainImageCount; i++)
+            _drawablesNeedsUpdate[binding][&drawable][i] = true;
+    }
+
     VkPipelineLayout PipelineLayout::getVulkanPipelineLayout() const
     {
         return _vulkanPipelineLayout;
@@ -304,6 +391,7 @@ namespace s3dl
         _swapchainImageCount(0),
 
         _alignment(Device::Active->getPhysicalDevice().properties.limits.minUniformBufferOffsetAlignment),
+        _globalRelocationCount(0),
 
         _vulkanDescriptorPool(VK_NULL_HANDLE)
     {
@@ -388,18 +476,36 @@ namespace s3dl
 
         uint32_t frame = swapchain.getCurrentImage();
 
-        if (_globalData.size() != 0)
-            _globalBuffers[frame]->setData(_globalData.data(), _globalData.size());
+        // Resources moved by the defragmenter or textures given another sampler have new handles, rewrite the descriptors
+        // using them
+
+        uint64_t relocationCount = Device::Active->getMemoryAllocator()->getRelocationCount() + Device::Active->getSamplerCache()->getReassignmentCount();
+        if (_globalRelocationCount != relocationCount)
+        {
+            std::vector<bool> relocated = updateRelocatedResources(_globalResources, _globalSamplers, _globalStorageBuffers);
+            for (int i(0); i < relocated.size(); i++)
+                if (relocated[i])
+                    _globalNeedsUpdate[i].assign(_swapchainImageCount, true);
+
+            _globalRelocationCount = relocationCount;
+        }
+
+        if (_globalData.size() != 0 && _globalDataNeedsUpload[frame])
+        {
+            std::memcpy(_globalBuffers[frame]->getMappedData(), _globalData.data(), _globalData.size());
+            _globalBuffers[frame]->flush(0, _globalData.size());
+            _globalDataNeedsUpload[frame] = false;
+        }
 
         std::vector<VkDescriptorBufferInfo> bufferInfos;
         std::vector<VkDescriptorImageInfo> imageInfos;
         for (int i(0); i < _globalBindings.size(); i++)
         {
+            bufferInfos.push_back({});
+            imageInfos.push_back({});
+
             if (_globalNeedsUpdate[i][frame])
             {
-                bufferInfos.push_back({});
-                imageInfos.push_back({});
-
                 switch (_globalBindingsLayouts[i].descriptorType)
                 {
                     case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
@@ -412,6 +518,14 @@ namespace s3dl
                         bufferInfos[i] = bufferInfo;
                         break;
                     }
+                    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                    {
+                        if (_globalStorageBuffers[i].buffer == VK_NULL_HANDLE)
+                            throw std::runtime_error("Storage buffer at global binding " + std::to_string(i) + " declared but not set.");
+
+                        bufferInfos[i] = _globalStorageBuffers[i];
+                        break;
+                    }
                     case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
                     {
                         if (_globalSamplers[i].first == VK_NULL_HANDLE)
@@ -451,13 +565,19 @@ namespace s3dl
                     case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
 
                         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                        descriptorWrite.pBufferInfo = &bufferInfos[descriptorWrites.size()];
+                        descriptorWrite.pBufferInfo = &bufferInfos[i];
+                        break;
+
+                    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+
+                        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                        descriptorWrite.pBufferInfo = &bufferInfos[i];
                         break;
 
                     case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
 
                         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                        descriptorWrite.pImageInfo = &imageInfos[descriptorWrites.size()];
+                        descriptorWrite.pImageInfo = &imageInfos[i];
                         break;
 
                     default:
@@ -485,8 +605,26 @@ namespace s3dl
 
         uint32_t frame = swapchain.getCurrentImage();
 
-        if (_drawablesData[&drawable].size() != 0)
-            _drawablesBuffers[&drawable][frame]->setData(_drawablesData[&drawable].data(), _drawablesData[&drawable].size());
+        // Resources moved by the defragmenter or textures given another sampler have new handles, rewrite the descriptors
+        // using them
+
+        uint64_t relocationCount = Device::Active->getMemoryAllocator()->getRelocationCount() + Device::Active->getSamplerCache()->getReassignmentCount();
+        if (_drawablesRelocationCount[&drawable] != relocationCount)
+        {
+            std::vector<bool> relocated = updateRelocatedResources(_drawablesResources[&drawable], _drawablesSamplers[&drawable], _drawablesStorageBuffers[&drawable]);
+            for (int i(0); i < relocated.size(); i++)
+                if (relocated[i])
+                    _drawablesNeedsUpdate[i][&drawable].assign(_swapchainImageCount, true);
+
+            _drawablesRelocationCount[&drawable] = relocationCount;
+        }
+
+        if (_drawablesData[&drawable].size() != 0 && _drawablesDataNeedsUpload[&drawable][frame])
+        {
+            std::memcpy(_drawablesBuffers[&drawable][frame]->getMappedData(), _drawablesData[&drawable].data(), _drawablesData[&drawable].size());
+            _drawablesBuffers[&drawable][frame]->flush(0, _drawablesData[&drawable].size());
+            _drawablesDataNeedsUpload[&drawable][frame] = false;
+        }
 
         std::vector<VkDescriptorBufferInfo> bufferInfos;
         std::vector<VkDescriptorImageInfo> imageInfos;
@@ -509,6 +647,14 @@ namespace s3dl
                         bufferInfos[i] = bufferInfo;
                         break;
                     }
+                    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                    {
+                        if (_drawablesStorageBuffers[&drawable][i].buffer == VK_NULL_HANDLE)
+                            throw std::runtime_error("Storage buffer at drawable binding " + std::to_string(i) + " declared but not set.");
+
+                        bufferInfos[i] = _drawablesStorageBuffers[&drawable][i];
+                        break;
+                    }
                     case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
                     {
                         if (_drawablesSamplers[&drawable][i].first == VK_NULL_HANDLE)
@@ -551,6 +697,12 @@ namespace s3dl
                         descriptorWrite.pBufferInfo = &bufferInfos[i];
                         break;
 
+                    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+
+                        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                        descriptorWrite.pBufferInfo = &bufferInfos[i];
+                        break;
+
                     case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
 
                         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -599,6 +751,9 @@ namespace s3dl
         _descriptorPoolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         _descriptorPoolSizes[2].descriptorCount = DESCRIPTOR_POOL_SIZE;
 
+        _descriptorPoolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        _descriptorPoolSizes[3].descriptorCount = DESCRIPTOR_POOL_SIZE;
+
         _descriptorPool.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         _descriptorPool.pNext = nullptr;
         _descriptorPool.flags = 0;
@@ -731,6 +886,8 @@ namespace s3dl
             return;
     
         _globalSamplers.resize(_globalBindings.size(), {VK_NULL_HANDLE, VK_NULL_HANDLE});
+        _globalStorageBuffers.resize(_globalBindings.size(), {VK_NULL_HANDLE, 0, 0});
+        _globalResources.resize(_globalBindings.size(), {nullptr, nullptr, {0, 1}, nullptr, nullptr});
 
         uint32_t n;
         n = _globalBindings.size() - 1;
@@ -743,7 +900,7 @@ namespace s3dl
         _globalBuffers.resize(_swapchainImageCount);
 
         for (int i(0); i < _swapchainImageCount; i++)
-            _globalBuffers[i] = new Buffer(totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            _globalBuffers[i] = new Buffer(totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryUsage::Dynamic, true);
     }
     
     void PipelineLayout::createVulkanDrawablesDescriptorSets(const Drawable& drawable)
@@ -773,6 +930,8 @@ namespace s3dl
             return;
     
         _drawablesSamplers[&drawable].resize(_drawablesBindings.size(), {VK_NULL_HANDLE, VK_NULL_HANDLE});
+        _drawablesStorageBuffers[&drawable].resize(_drawablesBindings.size(), {VK_NULL_HANDLE, 0, 0});
+        _drawablesResources[&drawable].resize(_drawablesBindings.size(), {nullptr, nullptr, {0, 1}, nullptr, nullptr});
 
         uint32_t n;
         n = _drawablesBindings.size() - 1;
@@ -785,7 +944,7 @@ namespace s3dl
         _drawablesBuffers[&drawable].resize(_swapchainImageCount);
 
         for (int i(0); i < _swapchainImageCount; i++)
-            _drawablesBuffers[&drawable][i] = new Buffer(totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            _drawablesBuffers[&drawable][i] = new Buffer(totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryUsage::Dynamic, true);
     }
 
     void PipelineLayout::destroyVulkanDescriptorPool()
@@ -862,6 +1021,8 @@ namespace s3dl
         _globalData.clear();
         _globalBuffers.clear();
         _globalSamplers.clear();
+        _globalStorageBuffers.clear();
+        _globalResources.clear();
     }
     
     void PipelineLayout::destroyVulkanDrawablesDescriptorSets(const Drawable& drawable)
@@ -877,6 +1038,8 @@ namespace s3dl
         _drawablesData[&drawable].clear();
         _drawablesBuffers[&drawable].clear();
         _drawablesSamplers[&drawable].clear();
+        _drawablesStorageBuffers[&drawable].clear();
+        _drawablesResources[&drawable].clear();
     }
 
     void PipelineLayout::computeBuffersOffsets()
@@ -904,12 +1067,15 @@ namespace s3dl
     {
         _globalNeedsUpdate.clear();
         _drawablesNeedsUpdate.clear();
+        _drawablesDataNeedsUpload.clear();
 
         _globalNeedsUpdate.resize(_globalBindings.size());
         for (int i(0); i < _globalNeedsUpdate.size(); i++)
             _globalNeedsUpdate[i].resize(_swapchainImageCount, true);
         
         _drawablesNeedsUpdate.resize(_drawablesBindings.size());
+
+        _globalDataNeedsUpload.assign(_swapchainImageCount, true);
     }
 
     void PipelineLayout::addDrawable(const Drawable& drawable)
@@ -925,9 +1091,51 @@ namespace s3dl
 
             for (int i(0); i < _drawablesNeedsUpdate.size(); i++)
                 _drawablesNeedsUpdate[i][&drawable].resize(_swapchainImageCount, true);
+            _drawablesDataNeedsUpload[&drawable].resize(_swapchainImageCount, true);
         }
     }
 
+    std::vector<bool> PipelineLayout::updateRelocatedResources(const std::vector<DescriptorResourceState>& resources, std::vector<std::pair<VkImageView, VkSampler>>& samplers, std::vector<VkDescriptorBufferInfo>& storageBuffers) const
+    {
+        std::vector<bool> relocated(resources.size(), false);
+
+        for (int i(0); i < resources.size(); i++)
+        {
+            VkImageView imageView(VK_NULL_HANDLE);
+            VkSampler sampler(VK_NULL_HANDLE);
+            if (resources[i].texture != nullptr)
+            {
+                imageView = resources[i].texture->getVulkanImageView(getDescriptorViewParameters(resources[i].texture->getFormat()));
+                sampler = resources[i].texture->getVulkanSampler();
+            }
+            else if (resources[i].textureArray != nullptr)
+            {
+                imageView = resources[i].textureArray->getVulkanImageView(getDescriptorViewParameters(resources[i].textureArray->getFormat(), resources[i].layerRange));
+                sampler = resources[i].textureArray->getVulkanSampler();
+            }
+
+            if (imageView != VK_NULL_HANDLE && imageView != samplers[i].first)
+            {
+                samplers[i].first = imageView;
+                relocated[i] = true;
+            }
+
+            if (sampler != VK_NULL_HANDLE && sampler != samplers[i].second)
+            {
+                samplers[i].second = sampler;
+                relocated[i] = true;
+            }
+
+            if (resources[i].buffer != nullptr && resources[i].buffer->getVulkanBuffer() != storageBuffers[i].buffer)
+            {
+                storageBuffers[i].buffer = resources[i].buffer->getVulkanBuffer();
+                relocated[i] = true;
+            }
+        }
+
+        return relocated;
+    }
+
     TextureViewParameters PipelineLayout::getDescriptorViewParameters(VkFormat format, std::array<uint32_t, 2> layerRange)
     {
         if (format == VK_FORMAT_D24_UNORM_S8_UINT)
@@ -0,0 +1,101 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    bool Readback::isComplete() const
+    {
+        if (!_complete && _swapchain != nullptr)
+            _complete = _swapchain->getCompletedFrameCount() > _frame;
+
+        return _complete;
+    }
+
+    void Readback::wait() const
+    {
+        if (isComplete())
+            return;
+
+        // Waiting for commands that were never submitted would never return
+
+        if (_swapchain == nullptr)
+            throw std::runtime_error("Cannot wait for a readback whose transfer batch has not been submitted.");
+        if (_frame >= _swapchain->getFrameCount())
+            throw std::runtime_error("Cannot wait for a readback recorded in the frame currently being recorded.");
+
+        _swapchain->waitFrame(_frame);
+        _complete = true;
+    }
+
+    uint64_t Readback::getSize() const
+    {
+        return _size;
+    }
+
+    const void* Readback::getData() const
+    {
+        if (!isComplete())
+            throw std::runtime_error("Cannot access the data of a readback before it is complete.");
+
+        // The copy lands in host cached memory, make it visible once
+
+        if (!_invalidated)
+        {
+            _buffer->invalidate(0, _size);
+            _invalidated = true;
+        }
+
+        return _buffer->getMappedData();
+    }
+
+    TextureData Readback::getTextureData() const
+    {
+        if (_imageSize.x == 0 || _imageSize.y == 0)
+            throw std::runtime_error("Cannot get texture data from the readback of a buffer.");
+
+        return TextureData(_imageSize.x, _imageSize.y, static_cast<const unsigned char*>(getData()));
+    }
+
+    Readback::~Readback()
+    {
+        // A staging buffer the GPU may still write to cannot be reused, it is destroyed once the frames using it are done
+
+        if (isComplete())
+            Device::Active->getStagingBufferPool()->release(_buffer);
+        else
+            Device::Active->getStagingBufferPool()->discard(_buffer);
+    }
+
+    Readback::Readback(uint64_t size, const uvec2& imageSize) :
+        _buffer(Device::Active->getStagingBufferPool()->acquire(size, MemoryUsage::Readback)),
+        _size(size),
+        _imageSize(imageSize),
+        _swapchain(nullptr),
+        _frame(0),
+        _complete(false),
+        _invalidated(false)
+    {
+    }
+
+    void Readback::recordBarriers(VkCommandBuffer commandBuffer, bool before) const
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+
+        if (before)
+        {
+            // Earlier commands of the frame may write what is read back
+
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+        else
+        {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+    }
+}
@@ -24,6 +24,15 @@ namespace s3dl
     void RenderTarget::beginRenderPass(const RenderPass& renderPass, const Framebuffer& framebuffer, const std::vector<VkClearValue>& clearValues)
     {
         endRenderPass();
+
+        // Attachments used by a previous pass, or sampled since, are put back in the layout this pass expects them in
+
+        ImageBarrierBatch barriers;
+        for (int i(0); i < renderPass._attachments.size(); i++)
+            if (framebuffer._attachments[i] != nullptr && renderPass._attachments[i].initialLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+                framebuffer._attachments[i]->setLayout(renderPass._attachments[i].initialLayout, barriers);
+        barriers.record(_swapchain->getCurrentCommandBuffer());
+
         _currentRenderPass = &renderPass;
         _currentFramebuffer = &framebuffer;
 
@@ -60,6 +69,31 @@ namespace s3dl
         vkCmdNextSubpass(_swapchain->getCurrentCommandBuffer(), VK_SUBPASS_CONTENTS_INLINE);
     }
 
+    void RenderTarget::setLayout(const TextureArray& textureArray, VkImageLayout layout, std::array<uint32_t, 2> layerRange, std::array<uint32_t, 2> mipRange)
+    {
+        ImageBarrierBatch barriers;
+        textureArray.setLayout(layout, barriers, layerRange, mipRange);
+        recordBarriers(barriers);
+    }
+
+    void RenderTarget::setLayout(const Texture& texture, VkImageLayout layout, std::array<uint32_t, 2> mipRange)
+    {
+        ImageBarrierBatch barriers;
+        texture.setLayout(layout, barriers, mipRange);
+        recordBarriers(barriers);
+    }
+
+    void RenderTarget::recordBarriers(ImageBarrierBatch& barriers)
+    {
+        if (barriers.isEmpty())
+            return;
+
+        // Barriers cannot be recorded inside a render pass, the current one is ended and the next pass begins after them
+
+        endRenderPass();
+        barriers.record(_swapchain->getCurrentCommandBuffer());
+    }
+
     void RenderTarget::display()
     {
         endRenderPass();
@@ -86,6 +120,13 @@ namespace s3dl
         if (_currentRenderPass != nullptr)
         {
             vkCmdEndRenderPass(_swapchain->getCurrentCommandBuffer());
+
+            // The render pass left its attachments in their final layout
+
+            for (int i(0); i < _currentRenderPass->_attachments.size(); i++)
+                if (_currentFramebuffer->_attachments[i] != nullptr)
+                    _currentFramebuffer->_attachments[i]->updateLayoutState(_currentRenderPass->_attachments[i].finalLayout);
+
             _currentRenderPass = nullptr;
         }
     }
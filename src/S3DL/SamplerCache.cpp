@@ -0,0 +1,101 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    VkSampler CachedSampler::getVulkanSampler() const
+    {
+        return _vulkanSampler;
+    }
+
+    CachedSampler::~CachedSampler()
+    {
+        // Frames in flight may still sample with it, it is destroyed once they are done
+
+        RetiredResource retiredResource{};
+        retiredResource.sampler = _vulkanSampler;
+
+        Device::Active->getDeletionQueue()->enqueue(retiredResource);
+    }
+
+    CachedSampler::CachedSampler(const VkSamplerCreateInfo& createInfo) :
+        _vulkanSampler(VK_NULL_HANDLE)
+    {
+        VkResult result = vkCreateSampler(Device::Active->getVulkanDevice(), &createInfo, nullptr, &_vulkanSampler);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create VkSampler. VkResult: " + std::to_string(result));
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkSampler successfully created." << std::endl;
+        #endif
+    }
+
+    SamplerCache::SamplerCache() :
+        _samplers(),
+        _reassignmentCount(0)
+    {
+    }
+
+    SamplerHandle SamplerCache::getSampler(const TextureSampler& sampler)
+    {
+        // Anisotropy is clamped to what the device supports before lookup, so that requests the device cannot tell
+        // apart share the same sampler
+
+        const PhysicalDevice& physicalDevice = Device::Active->getPhysicalDevice();
+
+        TextureSampler key(sampler);
+        if (!physicalDevice.features.samplerAnisotropy)
+            key.setAnisotropy(1.0f);
+        else if (key.getVulkanSamplerCreateInfo().maxAnisotropy > physicalDevice.properties.limits.maxSamplerAnisotropy)
+            key.setAnisotropy(physicalDevice.properties.limits.maxSamplerAnisotropy);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::unordered_map<TextureSampler, SamplerHandle, TextureSampler::Hasher, TextureSampler::Comparator>::iterator it = _samplers.find(key);
+        if (it != _samplers.end())
+            return it->second;
+
+        if (_samplers.size() >= physicalDevice.properties.limits.maxSamplerAllocationCount)
+            throw std::runtime_error("Cannot create more than " + std::to_string(physicalDevice.properties.limits.maxSamplerAllocationCount) + " samplers.");
+
+        SamplerHandle handle(new CachedSampler(key.getVulkanSamplerCreateInfo()));
+        _samplers.insert({key, handle});
+
+        return handle;
+    }
+
+    uint32_t SamplerCache::getSamplerCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _samplers.size();
+    }
+
+    void SamplerCache::collect()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Samplers only referenced by the cache are released, the deletion queue destroys them once unused
+
+        std::unordered_map<TextureSampler, SamplerHandle, TextureSampler::Hasher, TextureSampler::Comparator>::iterator it = _samplers.begin();
+        while (it != _samplers.end())
+        {
+            if (it->second.use_count() == 1)
+                it = _samplers.erase(it);
+            else
+                it++;
+        }
+    }
+
+    void SamplerCache::notifyReassignment()
+    {
+        _reassignmentCount++;
+    }
+
+    uint64_t SamplerCache::getReassignmentCount() const
+    {
+        return _reassignmentCount;
+    }
+
+    SamplerCache::~SamplerCache()
+    {
+    }
+}
@@ -0,0 +1,228 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const uint64_t StagingBufferPool::MIN_BUCKET_SIZE;
+    const uint64_t StagingBufferPool::DEFAULT_CAPACITY;
+
+    StagingBufferPool::StagingBufferPool(uint64_t capacity) :
+        _capacity(capacity),
+        _statistics{}
+    {
+    }
+
+    Buffer* StagingBufferPool::acquire(uint64_t size, MemoryUsage usage)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (usage != MemoryUsage::Upload && usage != MemoryUsage::Readback)
+            throw std::runtime_error("Staging buffers can only be acquired for upload or readback.");
+
+        std::map<uint64_t, std::vector<Buffer*>>& buckets = (usage == MemoryUsage::Upload) ? _uploadBuffers : _readbackBuffers;
+        uint64_t bucketSize = getBucketSize(size);
+        Buffer* buffer = nullptr;
+
+        // Reuse a cached buffer of the right bucket if there is one
+
+        std::map<uint64_t, std::vector<Buffer*>>::iterator it = buckets.find(bucketSize);
+        if (it != buckets.end())
+        {
+            buffer = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty())
+                buckets.erase(it);
+
+            _statistics.hits++;
+            _statistics.bufferCount--;
+            _statistics.bytesCached -= bucketSize;
+        }
+        else
+        {
+            buffer = new Buffer(bucketSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, usage, true);
+
+            _statistics.misses++;
+        }
+
+        _acquiredBuffers[buffer] = usage;
+
+        return buffer;
+    }
+
+    void StagingBufferPool::release(Buffer* buffer)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::unordered_map<const Buffer*, MemoryUsage>::iterator it = _acquiredBuffers.find(buffer);
+        if (it == _acquiredBuffers.end())
+            throw std::runtime_error("Cannot release a buffer that was not acquired from this staging pool.");
+
+        MemoryUsage usage = it->second;
+        _acquiredBuffers.erase(it);
+
+        // Buffers that would overflow the pool are simply destroyed
+
+        uint64_t bucketSize = buffer->getSize();
+        if (!fitsInCache(bucketSize, _statistics.bytesCached, _capacity))
+        {
+            delete buffer;
+            _statistics.evictions++;
+            return;
+        }
+
+        std::map<uint64_t, std::vector<Buffer*>>& buckets = (usage == MemoryUsage::Upload) ? _uploadBuffers : _readbackBuffers;
+        buckets[bucketSize].push_back(buffer);
+
+        _statistics.bufferCount++;
+        _statistics.bytesCached += bucketSize;
+    }
+
+    void StagingBufferPool::discard(Buffer* buffer)
+    {
+        // For buffers the GPU may still use, their destruction goes through the deletion queue
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (_acquiredBuffers.erase(buffer) == 0)
+                throw std::runtime_error("Cannot discard a buffer that was not acquired from this staging pool.");
+        }
+
+        delete buffer;
+    }
+
+    void StagingBufferPool::clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (std::pair<const uint64_t, std::vector<Buffer*>>& bucket: _uploadBuffers)
+            for (Buffer* buffer: bucket.second)
+                delete buffer;
+
+        for (std::pair<const uint64_t, std::vector<Buffer*>>& bucket: _readbackBuffers)
+            for (Buffer* buffer: bucket.second)
+                delete buffer;
+
+        _uploadBuffers.clear();
+        _readbackBuffers.clear();
+
+        _statistics.bufferCount = 0;
+        _statistics.bytesCached = 0;
+    }
+
+    void StagingBufferPool::setCapacity(uint64_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _capacity = capacity;
+        trim();
+    }
+
+    uint64_t StagingBufferPool::getCapacity() const
+    {
+        return _capacity;
+    }
+
+    StagingPoolStatistics StagingBufferPool::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return _statistics;
+    }
+
+    StagingBufferPool::~StagingBufferPool()
+    {
+        clear();
+
+        #ifndef NDEBUG
+        if (_acquiredBuffers.size() != 0)
+            std::clog << "<S3DL Debug> Staging buffer pool destroyed with " + std::to_string(_acquiredBuffers.size()) + " buffers still acquired." << std::endl;
+        #endif
+    }
+
+    uint64_t StagingBufferPool::getBucketSize(uint64_t size)
+    {
+        uint64_t bucketSize = MIN_BUCKET_SIZE;
+        while (bucketSize < size)
+            bucketSize *= 2;
+
+        return bucketSize;
+    }
+
+    bool StagingBufferPool::fitsInCache(uint64_t bucketSize, uint64_t bytesCached, uint64_t capacity)
+    {
+        return bytesCached + bucketSize <= capacity;
+    }
+
+    void StagingBufferPool::trim()
+    {
+        // Drop the biggest cached buffers first, they are the least likely to be reused
+
+        while (!fitsInCache(0, _statistics.bytesCached, _capacity))
+        {
+            std::map<uint64_t, std::vector<Buffer*>>* buckets = nullptr;
+            uint64_t bucketSize = 0;
+
+            if (!_uploadBuffers.empty() && _uploadBuffers.rbegin()->first > bucketSize)
+            {
+                buckets = &_uploadBuffers;
+                bucketSize = _uploadBuffers.rbegin()->first;
+            }
+            if (!_readbackBuffers.empty() && _readbackBuffers.rbegin()->first > bucketSize)
+            {
+                buckets = &_readbackBuffers;
+                bucketSize = _readbackBuffers.rbegin()->first;
+            }
+
+            std::vector<Buffer*>& bucket = (*buckets)[bucketSize];
+            delete bucket.back();
+            bucket.pop_back();
+            if (bucket.empty())
+                buckets->erase(bucketSize);
+
+            _statistics.evictions++;
+            _statistics.bufferCount--;
+            _statistics.bytesCached -= bucketSize;
+        }
+    }
+
+    StagingBuffer::StagingBuffer(uint64_t size, MemoryUsage usage) :
+        _buffer(Device::Active->getStagingBufferPool()->acquire(size, usage))
+    {
+    }
+
+    StagingBuffer::StagingBuffer(Buffer* buffer) :
+        _buffer(buffer)
+    {
+    }
+
+    Buffer* StagingBuffer::operator->() const
+    {
+        return _buffer;
+    }
+
+    Buffer& StagingBuffer::operator*() const
+    {
+        return *_buffer;
+    }
+
+    Buffer* StagingBuffer::get() const
+    {
+        return _buffer;
+    }
+
+    Buffer* StagingBuffer::detach()
+    {
+        // The caller takes the buffer over and becomes responsible for giving it back to the pool
+
+        Buffer* buffer = _buffer;
+        _buffer = nullptr;
+
+        return buffer;
+    }
+
+    StagingBuffer::~StagingBuffer()
+    {
+        if (_buffer != nullptr)
+            Device::Active->getStagingBufferPool()->release(_buffer);
+    }
+}
@@ -104,6 +104,32 @@ namespace s3dl
         return _imageCount;
     }
 
+    uint64_t Swapchain::getFrameCount() const
+    {
+        return _frameCount;
+    }
+
+    uint64_t Swapchain::getCompletedFrameCount() const
+    {
+        // Every frame before the oldest one still running on the GPU is done
+
+        uint64_t completedFrameCount = _frameCount;
+        for (int i(0); i < _renderFences.size(); i++)
+            if (vkGetFenceStatus(Device::Active->getVulkanDevice(), _renderFences[i]) != VK_SUCCESS)
+                completedFrameCount = std::min(completedFrameCount, _renderFrames[i]);
+
+        return completedFrameCount;
+    }
+
+    void Swapchain::waitFrame(uint64_t frame) const
+    {
+        // Frames complete in order, waiting for every submitted frame up to this one is enough
+
+        for (int i(0); i < _renderFences.size(); i++)
+            if (_renderFrames[i] <= frame)
+                vkWaitForFences(Device::Active->getVulkanDevice(), 1, &_renderFences[i], VK_TRUE, UINT64_MAX);
+    }
+
     VkCommandBuffer Swapchain::getCurrentCommandBuffer() const
     {
         return _commandBuffers[_currentImage];
@@ -115,13 +141,31 @@ namespace s3dl
 
         vkWaitForFences(Device::Active->getVulkanDevice(), 1, &_acquireFence, VK_TRUE, UINT64_MAX);
 
+        // Streamed textures sample the levels that became resident, scheduled uploads get this frame's budget, then
+        // uploads recorded until now are submitted first so that this frame can use them
+
+        Device::Active->getTextureStreamer()->update();
+        Device::Active->getUploadScheduler()->update(_frameCount);
+        Device::Active->getUploadManager()->flush();
+
         vkResetFences(Device::Active->getVulkanDevice(), 1, &_renderFences[_currentImage]);
+        _renderFrames[_currentImage] = _frameCount;
+        _renderSubmissions[_currentImage] = _submission;
         submitCommandBuffer(_currentImage);
         presentSurface(target, _currentImage);
 
         _currentImage = getNextImage(target);
 
         vkWaitForFences(Device::Active->getVulkanDevice(), 1, &_renderFences[_currentImage], VK_TRUE, UINT64_MAX);
+        _frameCount++;
+        _submission = Device::Active->getDeletionQueue()->beginSubmission();
+
+        // Destroy the resources released by frames that are now complete, samplers no texture uses anymore and views
+        // evicted from the cache included
+
+        Device::Active->getSamplerCache()->collect();
+        Device::Active->getImageViewCache()->evict();
+        Device::Active->getDeletionQueue()->collect();
 
         recreateCommandBuffer(_currentImage);
         startRecordingCommandBuffer(_currentImage);
@@ -132,10 +176,14 @@ namespace s3dl
         vkWaitForFences(Device::Active->getVulkanDevice(), 1, &_acquireFence, VK_TRUE, UINT64_MAX);
         for (int i(0); i < _renderFences.size(); i++)
             vkWaitForFences(Device::Active->getVulkanDevice(), 1, &_renderFences[i], VK_TRUE, UINT64_MAX);
+
+        Device::Active->getDeletionQueue()->collect();
     }
 
     Swapchain::~Swapchain()
     {
+        Device::Active->getDeletionQueue()->removeSwapchain(*this);
+
         vkDestroyFence(Device::Active->getVulkanDevice(), _acquireFence, nullptr);
 
         for (int i(0); i < _renderFences.size(); i++)
@@ -165,6 +213,8 @@ namespace s3dl
     void Swapchain::create(const RenderTarget& target)
     {
         _renderFences.resize(_imageCount);
+        _renderFrames.resize(_imageCount, 0);
+        _renderSubmissions.resize(_imageCount, 0);
         _renderSemaphores.resize(_imageCount);
         _commandBuffers.resize(_imageCount);
 
@@ -193,10 +243,27 @@ namespace s3dl
         std::clog << "<S3DL Debug> Swapchain update tools successfully created." << std::endl;
         #endif
 
+        _frameCount = 0;
+        _submission = Device::Active->getDeletionQueue()->beginSubmission();
+        Device::Active->getDeletionQueue()->addSwapchain(*this);
+
         _currentImage = getNextImage(target);
         startRecordingCommandBuffer(_currentImage);
     }
 
+    uint64_t Swapchain::getCompletedSubmissionCount() const
+    {
+        // Same as the completed frame count, but in the submission counter shared by every swapchain of the device. The
+        // frame being recorded is not complete either
+
+        uint64_t completedSubmissionCount = _submission;
+        for (int i(0); i < _renderFences.size(); i++)
+            if (vkGetFenceStatus(Device::Active->getVulkanDevice(), _renderFences[i]) != VK_SUCCESS)
+                completedSubmissionCount = std::min(completedSubmissionCount, _renderSubmissions[i]);
+
+        return completedSubmissionCount;
+    }
+
     void Swapchain::startRecordingCommandBuffer(unsigned int index) const
     {
         VkCommandBufferBeginInfo beginInfo{};
@@ -250,7 +317,7 @@ namespace s3dl
             submitInfo.pSignalSemaphores = &_renderSemaphores[index];
         }
         
-        VkResult result = vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, _renderFences[index]);
+        VkResult result = Device::Active->submit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, _renderFences[index]);
         if (result != VK_SUCCESS)
             throw std::runtime_error("Failed to submit draw command buffer. VkResult: " + std::to_string(result));
     }
@@ -268,7 +335,7 @@ namespace s3dl
             presentInfo.pImageIndices = &_currentImage;
             presentInfo.pResults = nullptr;
 
-            vkQueuePresentKHR(Device::Active->getVulkanPresentQueue(), &presentInfo);
+            Device::Active->present(presentInfo);
         }
     }
 
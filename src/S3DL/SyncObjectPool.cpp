@@ -0,0 +1,86 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    SyncObjectPool::SyncObjectPool() :
+        _fences(),
+        _semaphores()
+    {
+    }
+
+    VkFence SyncObjectPool::acquireFence()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_fences.empty())
+            {
+                VkFence fence = _fences.back();
+                _fences.pop_back();
+                return fence;
+            }
+        }
+
+        VkFenceCreateInfo fenceCreateInfo{};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceCreateInfo.flags = 0;
+
+        VkFence fence;
+        VkResult result = vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &fence);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create pooled fence. VkResult: " + std::to_string(result));
+
+        return fence;
+    }
+
+    void SyncObjectPool::releaseFence(VkFence fence)
+    {
+        // Fences are handed out unsignaled, the caller must have waited for any submission using it
+
+        vkResetFences(Device::Active->getVulkanDevice(), 1, &fence);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fences.push_back(fence);
+    }
+
+    VkSemaphore SyncObjectPool::acquireSemaphore()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_semaphores.empty())
+            {
+                VkSemaphore semaphore = _semaphores.back();
+                _semaphores.pop_back();
+                return semaphore;
+            }
+        }
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkSemaphore semaphore;
+        VkResult result = vkCreateSemaphore(Device::Active->getVulkanDevice(), &semaphoreInfo, nullptr, &semaphore);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create pooled semaphore. VkResult: " + std::to_string(result));
+
+        return semaphore;
+    }
+
+    void SyncObjectPool::releaseSemaphore(VkSemaphore semaphore)
+    {
+        // A binary semaphore can only be reused once the wait operation on it has completed
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _semaphores.push_back(semaphore);
+    }
+
+    SyncObjectPool::~SyncObjectPool()
+    {
+        for (VkFence fence: _fences)
+            vkDestroyFence(Device::Active->getVulkanDevice(), fence, nullptr);
+
+        for (VkSemaphore semaphore: _semaphores)
+            vkDestroySemaphore(Device::Active->getVulkanDevice(), semaphore, nullptr);
+    }
+}
@@ -2,9 +2,7 @@
 
 namespace s3dl
 {
-    TextureSampler::TextureSampler() :
-        _vulkanSamplerComputed(false),
-        _vulkanSampler(VK_NULL_HANDLE)
+    TextureSampler::TextureSampler()
     {
         _sampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
         _sampler.pNext = nullptr;
@@ -21,49 +19,94 @@ namespace s3dl
         _sampler.compareEnable = VK_FALSE;
         _sampler.compareOp = VK_COMPARE_OP_ALWAYS;
         _sampler.minLod = 0.0f;
-        _sampler.maxLod = 0.0f;
+        _sampler.maxLod = VK_LOD_CLAMP_NONE;
         _sampler.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
         _sampler.unnormalizedCoordinates = VK_FALSE;
     }
 
-    VkSampler TextureSampler::getVulkanSampler() const
+    void TextureSampler::setFilter(VkFilter magFilter, VkFilter minFilter, VkSamplerMipmapMode mipmapMode)
     {
-        if (!_vulkanSamplerComputed)
-            createVulkanSampler();
-        
-        return _vulkanSampler;
+        _sampler.magFilter = magFilter;
+        _sampler.minFilter = minFilter;
+        _sampler.mipmapMode = mipmapMode;
     }
 
-    TextureSampler::~TextureSampler()
+    void TextureSampler::setAddressMode(VkSamplerAddressMode u, VkSamplerAddressMode v, VkSamplerAddressMode w)
     {
-        destroyVulkanSampler();
+        _sampler.addressModeU = u;
+        _sampler.addressModeV = v;
+        _sampler.addressModeW = w;
     }
 
-    void TextureSampler::createVulkanSampler() const
+    void TextureSampler::setBorderColor(VkBorderColor borderColor)
     {
-        destroyVulkanSampler();
+        _sampler.borderColor = borderColor;
+    }
 
-        VkResult result = vkCreateSampler(Device::Active->getVulkanDevice(), &_sampler, nullptr, &_vulkanSampler);
-        if (result != VK_SUCCESS)
-            throw std::runtime_error("Failed to create VkSampler. VkResult: " + std::to_string(result));
-        
-        #ifndef NDEBUG
-        std::clog << "<S3DL Debug> VkSampler successfully created." << std::endl;
-        #endif
-        
-        _vulkanSamplerComputed = true;
+    void TextureSampler::setLodRange(float minLod, float maxLod, float lodBias)
+    {
+        _sampler.minLod = minLod;
+        _sampler.maxLod = maxLod;
+        _sampler.mipLodBias = lodBias;
     }
 
-    void TextureSampler::destroyVulkanSampler() const
+    void TextureSampler::setAnisotropy(float maxAnisotropy)
     {
-        if (_vulkanSampler != VK_NULL_HANDLE)
-            vkDestroySampler(Device::Active->getVulkanDevice(), _vulkanSampler, nullptr);
-        
-        _vulkanSampler = VK_NULL_HANDLE;
-        _vulkanSamplerComputed = false;
+        // A single sample per texel is the same as no anisotropic filtering at all
+
+        _sampler.anisotropyEnable = (maxAnisotropy > 1.0f) ? VK_TRUE : VK_FALSE;
+        _sampler.maxAnisotropy = std::max(maxAnisotropy, 1.0f);
     }
 
-    TextureViewParameters::TextureViewParameters(VkImageAspectFlags aspects, std::array<uint32_t, 2> layerRange)
+    const VkSamplerCreateInfo& TextureSampler::getVulkanSamplerCreateInfo() const
+    {
+        return _sampler;
+    }
+
+    std::size_t TextureSampler::Hasher::operator()(const TextureSampler& x) const
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().magFilter);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().minFilter);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().mipmapMode);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().addressModeU);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().addressModeV);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().addressModeW);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().mipLodBias);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().anisotropyEnable);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().maxAnisotropy);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().compareEnable);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().compareOp);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().minLod);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().maxLod);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().borderColor);
+        boost::hash_combine(seed, x.getVulkanSamplerCreateInfo().unnormalizedCoordinates);
+
+        return seed;
+    }
+
+    bool TextureSampler::Comparator::operator()(const TextureSampler& x, const TextureSampler& y) const
+    {
+        return (
+            x.getVulkanSamplerCreateInfo().magFilter               == y.getVulkanSamplerCreateInfo().magFilter               &&
+            x.getVulkanSamplerCreateInfo().minFilter               == y.getVulkanSamplerCreateInfo().minFilter               &&
+            x.getVulkanSamplerCreateInfo().mipmapMode              == y.getVulkanSamplerCreateInfo().mipmapMode              &&
+            x.getVulkanSamplerCreateInfo().addressModeU            == y.getVulkanSamplerCreateInfo().addressModeU            &&
+            x.getVulkanSamplerCreateInfo().addressModeV            == y.getVulkanSamplerCreateInfo().addressModeV            &&
+            x.getVulkanSamplerCreateInfo().addressModeW            == y.getVulkanSamplerCreateInfo().addressModeW            &&
+            x.getVulkanSamplerCreateInfo().mipLodBias              == y.getVulkanSamplerCreateInfo().mipLodBias              &&
+            x.getVulkanSamplerCreateInfo().anisotropyEnable        == y.getVulkanSamplerCreateInfo().anisotropyEnable        &&
+            x.getVulkanSamplerCreateInfo().maxAnisotropy           == y.getVulkanSamplerCreateInfo().maxAnisotropy           &&
+            x.getVulkanSamplerCreateInfo().compareEnable           == y.getVulkanSamplerCreateInfo().compareEnable           &&
+            x.getVulkanSamplerCreateInfo().compareOp               == y.getVulkanSamplerCreateInfo().compareOp               &&
+            x.getVulkanSamplerCreateInfo().minLod                  == y.getVulkanSamplerCreateInfo().minLod                  &&
+            x.getVulkanSamplerCreateInfo().maxLod                  == y.getVulkanSamplerCreateInfo().maxLod                  &&
+            x.getVulkanSamplerCreateInfo().borderColor             == y.getVulkanSamplerCreateInfo().borderColor             &&
+            x.getVulkanSamplerCreateInfo().unnormalizedCoordinates == y.getVulkanSamplerCreateInfo().unnormalizedCoordinates
+        );
+    }
+
+    TextureViewParameters::TextureViewParameters(VkImageAspectFlags aspects, std::array<uint32_t, 2> layerRange, std::array<uint32_t, 2> mipRange)
     {
         _view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         _view.pNext = nullptr;
@@ -79,8 +122,11 @@ namespace s3dl
         _view.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
         _view.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
         _view.subresourceRange.aspectMask = aspects;
-        _view.subresourceRange.baseMipLevel = 0;
-        _view.subresourceRange.levelCount = 1;
+        _view.subresourceRange.baseMipLevel = mipRange[0];
+        if (mipRange[1] == VK_REMAINING_MIP_LEVELS)
+            _view.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        else
+            _view.subresourceRange.levelCount = mipRange[1] - mipRange[0];
         _view.subresourceRange.baseArrayLayer = layerRange[0];
         _view.subresourceRange.layerCount = layerRange[1] - layerRange[0];
     }
@@ -143,111 +189,93 @@ namespace s3dl
         );
     }
 
-    TextureArray::TextureArray(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t layerCount) :
+    uint32_t TextureArray::getMipLevelCount(const uvec2& size)
+    {
+        // Each level halves the previous one, down to a single texel
+
+        uint32_t mipLevels = 1;
+        for (uint32_t extent = std::max(size.x, size.y); extent > 1; extent /= 2)
+            mipLevels++;
+
+        return mipLevels;
+    }
+
+    TextureArray::TextureArray(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t layerCount, bool mipmapped) :
         _size(size),
         _layerCount(layerCount),
+        _mipLevels(mipmapped ? getMipLevelCount(size) : 1),
         _format(format),
         _tiling(tiling),
         _usage(usage),
         
-        _vulkanImageMemory(VK_NULL_HANDLE),
+        _imageMemory{},
         _vulkanImage(VK_NULL_HANDLE),
-        _vulkanImageViews({}),
-        _sampler(new TextureSampler()),
-        _deleteSampler(true),
+        _sampler(Device::Active->getSamplerCache()->getSampler(TextureSampler())),
 
-        _currentLayout(VK_IMAGE_LAYOUT_UNDEFINED)
+        _layouts(_layerCount * _mipLevels, VK_IMAGE_LAYOUT_UNDEFINED)
     {
-        // Create vulkan image
+        // Levels are generated by blitting each one into the next, which the format must support
 
-        VkImageCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.imageType = VK_IMAGE_TYPE_2D;
-        createInfo.format = _format;
-        createInfo.extent.width = _size.x;
-        createInfo.extent.height = _size.y;
-        createInfo.extent.depth = 1;
-        createInfo.mipLevels = 1;
-        createInfo.arrayLayers = _layerCount;
-        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        createInfo.tiling = _tiling;
-        createInfo.usage = _usage;
-        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        createInfo.queueFamilyIndexCount = 0;
-        createInfo.pQueueFamilyIndices = nullptr;
-        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        VkResult result = vkCreateImage(Device::Active->getVulkanDevice(), &createInfo, nullptr, &_vulkanImage);
-        if (result != VK_SUCCESS)
-            throw std::runtime_error("Failed to create image. VkResult: " + std::to_string(result));
-
-        // Allocate memory for image
-
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(Device::Active->getVulkanDevice(), _vulkanImage, &memRequirements);
+        if (_mipLevels > 1)
+        {
+            VkFormatProperties formatProperties;
+            vkGetPhysicalDeviceFormatProperties(Device::Active->getPhysicalDevice().getVulkanPhysicalDevice(), _format, &formatProperties);
 
-        const VkPhysicalDeviceMemoryProperties& memProperties = Device::Active->getPhysicalDevice().memoryProperties;
-        uint32_t index(0);
-        for (; index < memProperties.memoryTypeCount; index++)
-            if ((memRequirements.memoryTypeBits & (1 << index)) && (memProperties.memoryTypes[index].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-                break;
-        
-        if (index == memProperties.memoryTypeCount)
-            throw std::runtime_error("Failed to find suitable memory type for image creation.");
+            const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = index;
+            VkFormatFeatureFlags features = (_tiling == VK_IMAGE_TILING_LINEAR) ? formatProperties.linearTilingFeatures : formatProperties.optimalTilingFeatures;
+            if ((features & blitFeatures) != blitFeatures)
+                throw std::runtime_error("Cannot create mipmapped texture, format " + std::to_string(_format) + " does not support blits with this tiling.");
 
-        result = vkAllocateMemory(Device::Active->getVulkanDevice(), &allocInfo, nullptr, &_vulkanImageMemory);
-        if (result != VK_SUCCESS)
-            throw std::runtime_error("Failed to allocate image memory. VkResult: " + std::to_string(result));
+            _usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
-        vkBindImageMemory(Device::Active->getVulkanDevice(), _vulkanImage, _vulkanImageMemory, 0);
-        
-        #ifndef NDEBUG
-        std::clog << "<S3DL Debug> VkImage successfully created and allocated." << std::endl;
-        #endif
+        createVulkanImage();
     }
 
-    void TextureArray::fillFromTextureData(const TextureData& textureData, uint32_t layer)
+    TextureArray::TextureArray(const CompressedTextureData& textureData, VkImageUsageFlags usage) : TextureArray(textureData, usage, textureData.getLayerCount())
     {
-        Buffer stagingBuffer(textureData.getRawSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        stagingBuffer.setData(textureData.getRawData(), textureData.getRawSize());
-        fillFromBuffer(stagingBuffer, layer, 1);
     }
 
-    void TextureArray::fillFromBuffer(const Buffer& buffer, uint32_t firstLayer, uint32_t layerCount)
+    void TextureArray::fillFromTextureData(const TextureData& textureData, uint32_t layer, TransferBatch* batch)
     {
-        VkImageLayout layout = _currentLayout;
-        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            fillFromTextureData(textureData, layer, &transferBatch);
+            transferBatch.submit();
+            return;
+        }
 
-        // Start recording a command buffer
+        // Images of a same batch share its staging buffers, each one at its own offset
 
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-        allocInfo.commandBufferCount = 1;
+        std::pair<const Buffer*, uint64_t> staging = batch->stage(textureData.getRawData(), textureData.getRawSize());
+        fillFromBuffer(*staging.first, layer, 1, batch, staging.second);
+    }
 
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
+    void TextureArray::fillFromBuffer(const Buffer& buffer, uint32_t firstLayer, uint32_t layerCount, TransferBatch* batch, uint64_t bufferOffset)
+    {
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            fillFromBuffer(buffer, firstLayer, layerCount, &transferBatch, bufferOffset);
+            transferBatch.submit();
+            return;
+        }
 
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        // Only the filled layers are transitioned, the others keep their layout
 
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        std::vector<VkImageLayout> layouts = _layouts;
+        ImageBarrierBatch barriers;
+        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, barriers, {firstLayer, firstLayer + layerCount});
+        barriers.record(batch->getVulkanCommandBuffer());
 
         // Create copy command
 
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
+        region.bufferOffset = bufferOffset;
+        region.bufferRowLength = _size.x;
+        region.bufferImageHeight = _size.y;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         region.imageSubresource.mipLevel = 0;
         region.imageSubresource.baseArrayLayer = firstLayer;
@@ -255,59 +283,33 @@ namespace s3dl
         region.imageOffset = {0, 0, 0};
         region.imageExtent = {_size.x, _size.y, 1};
 
-        vkCmdCopyBufferToImage(commandBuffer, buffer.getVulkanBuffer(), _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        // Finish recording the command buffer and execute it
-
-        vkEndCommandBuffer(commandBuffer);
-
-        VkFence transferFence;
-        VkFenceCreateInfo fenceCreateInfo{};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        vkCmdCopyBufferToImage(batch->getVulkanCommandBuffer(), buffer.getVulkanBuffer(), _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
-        vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
+        if (_mipLevels > 1)
+            recordMipmapGeneration(batch->getVulkanCommandBuffer(), firstLayer, layerCount);
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-
-        vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-        vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
-        
-        vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
-
-        vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-        vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
-
-        if (layout != VK_IMAGE_LAYOUT_UNDEFINED)
-            setLayout(layout);
+        restoreLayouts(layouts, barriers);
+        barriers.record(batch->getVulkanCommandBuffer());
     }
 
-    void TextureArray::fillFromTextureArray(const TextureArray& textureArray, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount)
+    void TextureArray::fillFromTextureArray(const TextureArray& textureArray, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount, TransferBatch* batch)
     {
-        VkImageLayout srcLayout = textureArray._currentLayout;
-        textureArray.setLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-        VkImageLayout dstLayout = _currentLayout;
-        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        // Start recording a command buffer
-
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            fillFromTextureArray(textureArray, srcFirstLayer, dstFirstLayer, layerCount, &transferBatch);
+            transferBatch.submit();
+            return;
+        }
 
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        // Both images are transitioned by the same barrier
 
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        std::vector<VkImageLayout> srcLayouts = textureArray._layouts;
+        std::vector<VkImageLayout> dstLayouts = _layouts;
+        ImageBarrierBatch barriers;
+        textureArray.setLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, barriers, {srcFirstLayer, srcFirstLayer + layerCount}, {0, 1});
+        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, barriers, {dstFirstLayer, dstFirstLayer + layerCount});
+        barriers.record(batch->getVulkanCommandBuffer());
 
         // Create copy command
         
@@ -324,230 +326,431 @@ namespace s3dl
         copyInfo.dstOffset = {0, 0, 0};
         copyInfo.extent = {_size.x, _size.y, 1};
 
-        vkCmdCopyImage(commandBuffer, textureArray._vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyInfo);
+        vkCmdCopyImage(batch->getVulkanCommandBuffer(), textureArray._vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyInfo);
 
-        // Finish recording the command buffer and execute it
+        if (_mipLevels > 1)
+            recordMipmapGeneration(batch->getVulkanCommandBuffer(), dstFirstLayer, layerCount);
+
+        textureArray.restoreLayouts(srcLayouts, barriers);
+        restoreLayouts(dstLayouts, barriers);
+        barriers.record(batch->getVulkanCommandBuffer());
+    }
+
+    void TextureArray::fillFromTexture(const Texture& texture, uint32_t dstLayer, TransferBatch* batch)
+    {
+        fillFromTextureArray(texture, 0, dstLayer, 1, batch);
+    }
 
-        vkEndCommandBuffer(commandBuffer);
+    void TextureArray::fillFromCompressedTextureData(const CompressedTextureData& textureData, uint32_t srcFirstLayer, uint32_t dstFirstLayer, uint32_t layerCount, TransferBatch* batch)
+    {
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            fillFromCompressedTextureData(textureData, srcFirstLayer, dstFirstLayer, layerCount, &transferBatch);
+            transferBatch.submit();
+            return;
+        }
 
-        VkFence transferFence;
-        VkFenceCreateInfo fenceCreateInfo{};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        if (textureData.getSize().x != _size.x || textureData.getSize().y != _size.y || textureData.getMipLevels() < _mipLevels)
+            throw std::runtime_error("Cannot fill texture from compressed texture data of different size or with less mip levels.");
+        if (srcFirstLayer + layerCount > textureData.getLayerCount() || dstFirstLayer + layerCount > _layerCount)
+            throw std::runtime_error("Cannot copy " + std::to_string(layerCount) + " layers between compressed texture data of " + std::to_string(textureData.getLayerCount()) + " layers and texture array of " + std::to_string(_layerCount) + " layers.");
+        if (_format != textureData.getFormat() && _format != textureData.getDecodedFormat())
+            throw std::runtime_error("Cannot fill texture from compressed texture data of another format.");
 
-        vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
+        std::vector<VkImageLayout> layouts = _layouts;
+        ImageBarrierBatch barriers;
+        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, barriers, {dstFirstLayer, dstFirstLayer + layerCount});
+        barriers.record(batch->getVulkanCommandBuffer());
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        // Blocks are uploaded as they are if the device supports the format, otherwise each level is decoded first
 
-        vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-        vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
-        
-        vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+        for (uint32_t level = 0; level < _mipLevels; level++)
+        {
+            uvec2 levelSize = textureData.getLevelSize(level);
 
-        vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-        vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
+            for (uint32_t i = 0; i < layerCount; i++)
+            {
+                std::pair<const Buffer*, uint64_t> staging;
+                if (_format == textureData.getFormat())
+                    staging = batch->stage(textureData.getRawData(level, srcFirstLayer + i), textureData.getRawSize(level));
+                else
+                {
+                    TextureData decodedData = textureData.decode(level, srcFirstLayer + i);
+                    staging = batch->stage(decodedData.getRawData(), decodedData.getRawSize());
+                }
+
+                VkBufferImageCopy region{};
+                region.bufferOffset = staging.second;
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = level;
+                region.imageSubresource.baseArrayLayer = dstFirstLayer + i;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = {0, 0, 0};
+                region.imageExtent = {levelSize.x, levelSize.y, 1};
+
+                vkCmdCopyBufferToImage(batch->getVulkanCommandBuffer(), staging.first->getVulkanBuffer(), _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+            }
+        }
 
-        if (srcLayout != VK_IMAGE_LAYOUT_UNDEFINED)
-            textureArray.setLayout(srcLayout);
-        if (dstLayout != VK_IMAGE_LAYOUT_UNDEFINED)
-            setLayout(dstLayout);
+        restoreLayouts(layouts, barriers);
+        barriers.record(batch->getVulkanCommandBuffer());
     }
 
-    void TextureArray::fillFromTexture(const Texture& texture, uint32_t dstLayer)
+    void TextureArray::generateMipmaps(TransferBatch* batch)
     {
-        fillFromTextureArray(texture, 0, dstLayer, 1);
+        if (batch == nullptr)
+        {
+            TransferBatch transferBatch;
+            generateMipmaps(&transferBatch);
+            transferBatch.submit();
+            return;
+        }
+
+        if (_mipLevels == 1)
+            return;
+
+        std::vector<VkImageLayout> layouts = _layouts;
+        ImageBarrierBatch barriers;
+        setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, barriers);
+        barriers.record(batch->getVulkanCommandBuffer());
+
+        recordMipmapGeneration(batch->getVulkanCommandBuffer(), 0, _layerCount);
+
+        restoreLayouts(layouts, barriers);
+        barriers.record(batch->getVulkanCommandBuffer());
     }
 
     void TextureArray::setSampler(const TextureSampler& sampler)
     {
-        _sampler = &sampler;
-        _deleteSampler = false;
+        // Textures with the same sampler configuration share the same VkSampler, descriptors using the previous one are
+        // rewritten on their next bind
+
+        SamplerHandle handle = Device::Active->getSamplerCache()->getSampler(sampler);
+        if (handle == _sampler)
+            return;
+
+        _sampler = handle;
+        Device::Active->getSamplerCache()->notifyReassignment();
     }
 
-    void TextureArray::updateLayoutState(VkImageLayout layout) const
+    void TextureArray::updateLayoutState(VkImageLayout layout, std::array<uint32_t, 2> layerRange, std::array<uint32_t, 2> mipRange) const
     {
-        _currentLayout = layout;
+        layerRange = resolveRange(layerRange, _layerCount);
+        mipRange = resolveRange(mipRange, _mipLevels);
+
+        for (uint32_t layer = layerRange[0]; layer < layerRange[1]; layer++)
+            for (uint32_t level = mipRange[0]; level < mipRange[1]; level++)
+                _layouts[layer * _mipLevels + level] = layout;
     }
 
-    void TextureArray::setLayout(VkImageLayout layout) const
+    void TextureArray::setLayout(VkImageLayout layout, TransferBatch* batch) const
     {
-        if (layout == _currentLayout)
+        ImageBarrierBatch barriers;
+        setLayout(layout, barriers);
+
+        if (barriers.isEmpty())
             return;
 
-        // Start recording a command buffer
+        if (batch == nullptr)
+            barriers.submit();
+        else
+            barriers.record(batch->getVulkanCommandBuffer());
+    }
+
+    void TextureArray::setLayout(VkImageLayout layout, ImageBarrierBatch& barriers, std::array<uint32_t, 2> layerRange, std::array<uint32_t, 2> mipRange) const
+    {
+        layerRange = resolveRange(layerRange, _layerCount);
+        mipRange = resolveRange(mipRange, _mipLevels);
+
+        std::vector<VkImageLayout> layouts = _layouts;
+        for (uint32_t layer = layerRange[0]; layer < layerRange[1]; layer++)
+            for (uint32_t level = mipRange[0]; level < mipRange[1]; level++)
+                layouts[layer * _mipLevels + level] = layout;
+
+        transitionTo(layouts, barriers);
+    }
+
+    void TextureArray::setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout, std::array<uint32_t, 2> layerRange, std::array<uint32_t, 2> mipRange) const
+    {
+        // Recorded in a command buffer of the caller, nothing is submitted nor waited for
+
+        ImageBarrierBatch barriers;
+        setLayout(layout, barriers, layerRange, mipRange);
+        barriers.record(commandBuffer);
+    }
+
+    VkImageLayout TextureArray::getLayout(uint32_t layer, uint32_t mipLevel) const
+    {
+        if (layer >= _layerCount || mipLevel >= _mipLevels)
+            throw std::runtime_error("Cannot get layout of level " + std::to_string(mipLevel) + " of layer " + std::to_string(layer) + " of texture array of " + std::to_string(_layerCount) + " layers and " + std::to_string(_mipLevels) + " levels.");
+
+        return _layouts[layer * _mipLevels + mipLevel];
+    }
+
+    void TextureArray::transitionTo(const std::vector<VkImageLayout>& layouts, ImageBarrierBatch& barriers) const
+    {
+        addTransitions(barriers, _vulkanImage, _layouts, layouts);
+        _layouts = layouts;
+    }
+
+    void TextureArray::restoreLayouts(const std::vector<VkImageLayout>& layouts, ImageBarrierBatch& barriers) const
+    {
+        // Subresources that were never used have nothing to go back to and stay as they are
+
+        std::vector<VkImageLayout> target = _layouts;
+        for (uint32_t i = 0; i < target.size(); i++)
+            if (layouts[i] != VK_IMAGE_LAYOUT_UNDEFINED)
+                target[i] = layouts[i];
+
+        transitionTo(target, barriers);
+    }
+
+    void TextureArray::addTransitions(ImageBarrierBatch& barriers, VkImage image, const std::vector<VkImageLayout>& oldLayouts, const std::vector<VkImageLayout>& newLayouts) const
+    {
+        // Consecutive layers going through the same transitions share their barriers, and so do consecutive levels
+
+        VkImageSubresourceRange range{};
+        range.aspectMask = getAvailableAspects(_format);
+
+        uint32_t firstLayer = 0;
+        for (uint32_t layer = 1; layer <= _layerCount; layer++)
+        {
+            if (layer < _layerCount
+                && std::equal(oldLayouts.begin() + layer * _mipLevels, oldLayouts.begin() + (layer + 1) * _mipLevels, oldLayouts.begin() + firstLayer * _mipLevels)
+                && std::equal(newLayouts.begin() + layer * _mipLevels, newLayouts.begin() + (layer + 1) * _mipLevels, newLayouts.begin() + firstLayer * _mipLevels))
+                continue;
 
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-        allocInfo.commandBufferCount = 1;
+            range.baseArrayLayer = firstLayer;
+            range.layerCount = layer - firstLayer;
 
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
+            uint32_t firstLevel = 0;
+            for (uint32_t level = 1; level <= _mipLevels; level++)
+            {
+                uint32_t first = firstLayer * _mipLevels + firstLevel;
+                uint32_t current = firstLayer * _mipLevels + level;
+                if (level < _mipLevels && oldLayouts[current] == oldLayouts[first] && newLayouts[current] == newLayouts[first])
+                    continue;
+
+                if (oldLayouts[first] != newLayouts[first] && newLayouts[first] != VK_IMAGE_LAYOUT_UNDEFINED)
+                {
+                    range.baseMipLevel = firstLevel;
+                    range.levelCount = level - firstLevel;
+                    barriers.addTransition(image, range, oldLayouts[first], newLayouts[first]);
+                }
+
+                firstLevel = level;
+            }
+
+            firstLayer = layer;
+        }
+    }
 
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    void TextureArray::recordMipmapGeneration(VkCommandBuffer commandBuffer, uint32_t firstLayer, uint32_t layerCount) const
+    {
+        // Linear filtering is only used if the format supports it for blits
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(Device::Active->getPhysicalDevice().getVulkanPhysicalDevice(), _format, &formatProperties);
 
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        VkFormatFeatureFlags features = (_tiling == VK_IMAGE_TILING_LINEAR) ? formatProperties.linearTilingFeatures : formatProperties.optimalTilingFeatures;
+        VkFilter filter = (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
 
-        // Create barrier
+        // Every level of the layers is in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, each one is made a source once written
 
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = _currentLayout;
-        barrier.newLayout = layout;
         barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.image = _vulkanImage;
         barrier.subresourceRange.aspectMask = getAvailableAspects(_format);
-        barrier.subresourceRange.baseMipLevel = 0;
         barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = _layerCount;
+        barrier.subresourceRange.baseArrayLayer = firstLayer;
+        barrier.subresourceRange.layerCount = layerCount;
 
-        VkPipelineStageFlags sourceStage;
-        VkPipelineStageFlags destinationStage;
+        int32_t width = _size.x;
+        int32_t height = _size.y;
 
-        switch (_currentLayout)
+        for (uint32_t i = 1; i < _mipLevels; i++)
         {
-            case VK_IMAGE_LAYOUT_UNDEFINED:
-                sourceStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-                barrier.srcAccessMask = 0;
-                break;
-            case VK_IMAGE_LAYOUT_GENERAL:
-                sourceStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-                barrier.srcAccessMask = 0;
-                break;
-            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-                barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-                barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                break;
-            default:
-                throw std::invalid_argument("Unsupported layout transition.");
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            VkImageBlit blit{};
+            blit.srcSubresource.aspectMask = getAvailableAspects(_format);
+            blit.srcSubresource.mipLevel = i - 1;
+            blit.srcSubresource.baseArrayLayer = firstLayer;
+            blit.srcSubresource.layerCount = layerCount;
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {width, height, 1};
+            blit.dstSubresource = blit.srcSubresource;
+            blit.dstSubresource.mipLevel = i;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {std::max(width / 2, 1), std::max(height / 2, 1), 1};
+
+            vkCmdBlitImage(commandBuffer, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, filter);
+
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
         }
 
-        switch (layout)
-        {
-            case VK_IMAGE_LAYOUT_UNDEFINED:
-                destinationStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-                barrier.dstAccessMask = 0;
-                break;
-            case VK_IMAGE_LAYOUT_GENERAL:
-                destinationStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-                barrier.dstAccessMask = 0;
-                break;
-            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-                destinationStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-                destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-                barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                destinationStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-                destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                break;
-            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-                destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                break;
-            default:
-                throw std::invalid_argument("Unsupported layout transition.");
-        }
+        // Put the source levels back so that the whole image is in the layout it is tracked in
 
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            sourceStage, destinationStage,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = _mipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 
-        // Finish recording the command buffer and execute it
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
 
-        vkEndCommandBuffer(commandBuffer);
+    VkFormat TextureArray::getFormat() const
+    {
+        return _format;
+    }
 
-        VkFence transferFence;
-        VkFenceCreateInfo fenceCreateInfo{};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    TextureData TextureArray::getTextureData(uint32_t layer) const
+    {
+        TransferBatch batch;
+        ReadbackHandle readback = getTextureDataAsync(batch, layer);
+        batch.submit();
 
-        vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
+        return readback->getTextureData();
+    }
 
+    ReadbackHandle TextureArray::getTextureDataAsync(RenderTarget& target, uint32_t layer) const
+    {
+        // Read the layer after the commands recorded so far in the frame, the result is there once the frame is done.
+        // Copies cannot be recorded inside a render pass, the current one is ended and the next pass begins after them
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        target.endRenderPass();
 
-        vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-        vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
-        
-        vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+        ReadbackHandle readback = recordReadback(target._swapchain->getCurrentCommandBuffer(), layer);
+        readback->_swapchain = target._swapchain;
+        readback->_frame = target._swapchain->getFrameCount();
 
-        vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-        vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
+        return readback;
+    }
 
-        // Change current layout
+    ReadbackHandle TextureArray::getTextureDataAsync(TransferBatch& batch, uint32_t layer) const
+    {
+        ReadbackHandle readback = recordReadback(batch.getVulkanCommandBuffer(), layer);
+        batch.addReadback(readback);
 
-        _currentLayout = layout;
+        return readback;
     }
 
-    VkFormat TextureArray::getFormat() const
+    const uvec2& TextureArray::getSize() const
     {
-        return _format;
+        return _size;
     }
 
-    TextureData TextureArray::getTextureData(uint32_t layer) const
+    uint32_t TextureArray::getMipLevels() const
+    {
+        return _mipLevels;
+    }
+
+    VkImage TextureArray::getVulkanImage() const
+    {
+        return _vulkanImage;
+    }
+
+    VkImageView TextureArray::getVulkanImageView(const TextureViewParameters& viewParameters) const
     {
-        VkImageLayout layout = _currentLayout;
-        setLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        // Views are shared by every thread through the device cache, which may evict the ones that are not pinned
 
-        // Start recording a command buffer
+        return Device::Active->getImageViewCache()->getView(_vulkanImage, _format, viewParameters);
+    }
+
+    ImageViewPinHandle TextureArray::pinVulkanImageView(const TextureViewParameters& viewParameters) const
+    {
+        return Device::Active->getImageViewCache()->pinView(_vulkanImage, viewParameters);
+    }
+
+    void TextureArray::prewarmVulkanImageViews(const std::vector<TextureViewParameters>& viewParameters) const
+    {
+        Device::Active->getImageViewCache()->prewarm(_vulkanImage, _format, viewParameters);
+    }
+
+    VkSampler TextureArray::getVulkanSampler() const
+    {
+        return _sampler->getVulkanSampler();
+    }
 
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = Device::Active->getVulkanCommandPool();
-        allocInfo.commandBufferCount = 1;
+    TextureArray::~TextureArray()
+    {
+        // Streaming and uploads not submitted yet would write to the destroyed image, they are cancelled
 
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &commandBuffer);
+        Device::Active->getTextureStreamer()->cancel(*this);
+        Device::Active->getUploadScheduler()->cancel(*this);
 
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        // Frames in flight may still use the image and its views, they are destroyed once they are done
 
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        RetiredResource retiredResource{};
+        retiredResource.image = _vulkanImage;
+        retiredResource.allocation = _imageMemory;
+        Device::Active->getImageViewCache()->releaseImage(_vulkanImage, retiredResource.imageViews);
 
-        // Create command
+        Device::Active->getDeletionQueue()->enqueue(retiredResource);
         
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkImage successfully queued for destruction." << std::endl;
+        #endif
+    }
+
+    bool TextureArray::isRelocatable() const
+    {
+        // Attachments are written by every frame and referenced by framebuffers, so they stay where they are
+
+        const VkImageUsageFlags transferUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        return _imageMemory.category != MemoryCategory::Attachment && (_usage & transferUsage) == transferUsage;
+    }
+
+    TextureArray::TextureArray(const CompressedTextureData& textureData, VkImageUsageFlags usage, uint32_t layerCount) :
+        _size(textureData.getSize()),
+        _layerCount(layerCount),
+        _mipLevels(textureData.getMipLevels()),
+        _format(getCompressedTextureFormat(textureData)),
+        _tiling(VK_IMAGE_TILING_OPTIMAL),
+        _usage(usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT),
+
+        _imageMemory{},
+        _vulkanImage(VK_NULL_HANDLE),
+        _sampler(Device::Active->getSamplerCache()->getSampler(TextureSampler())),
+
+        _layouts(_layerCount * _mipLevels, VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        createVulkanImage();
+    }
+
+    ReadbackHandle TextureArray::recordReadback(VkCommandBuffer commandBuffer, uint32_t layer) const
+    {
+        if (layer >= _layerCount)
+            throw std::runtime_error("Cannot read back layer " + std::to_string(layer) + " of texture array of " + std::to_string(_layerCount) + " layers.");
+        if (!(_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+            throw std::runtime_error("Cannot read back a texture created without VK_IMAGE_USAGE_TRANSFER_SRC_BIT.");
+
+        ReadbackHandle readback(new Readback(_size.x * _size.y * 4, _size));
+
+        // Copy the layer in the readback buffer, then restore the layout the image was used in
+
+        std::vector<VkImageLayout> layouts = _layouts;
+        ImageBarrierBatch barriers;
+
+        readback->recordBarriers(commandBuffer, true);
+        setLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, barriers, {layer, layer + 1}, {0, 1});
+        barriers.record(commandBuffer);
+
         VkBufferImageCopy transferInfo{};
         transferInfo.bufferOffset = 0;
         transferInfo.bufferRowLength = 0;
@@ -559,103 +762,105 @@ namespace s3dl
         transferInfo.imageOffset = {0, 0, 0};
         transferInfo.imageExtent = {_size.x, _size.y, 1};
 
-        Buffer buffer(_size.x * _size.y * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-        vkCmdCopyImageToBuffer(commandBuffer, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer.getVulkanBuffer(), 1, &transferInfo);
+        vkCmdCopyImageToBuffer(commandBuffer, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback->_buffer->getVulkanBuffer(), 1, &transferInfo);
 
-        // Finish recording the command buffer and execute it
+        restoreLayouts(layouts, barriers);
+        barriers.record(commandBuffer);
 
-        vkEndCommandBuffer(commandBuffer);
+        readback->recordBarriers(commandBuffer, false);
 
-        VkFence transferFence;
-        VkFenceCreateInfo fenceCreateInfo{};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        return readback;
+    }
 
-        vkCreateFence(Device::Active->getVulkanDevice(), &fenceCreateInfo, nullptr, &transferFence);
+    void TextureArray::createVulkanImage()
+    {
+        // Create vulkan image
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        VkImageCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.imageType = VK_IMAGE_TYPE_2D;
+        createInfo.format = _format;
+        createInfo.extent.width = _size.x;
+        createInfo.extent.height = _size.y;
+        createInfo.extent.depth = 1;
+        createInfo.mipLevels = _mipLevels;
+        createInfo.arrayLayers = _layerCount;
+        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.tiling = _tiling;
+        createInfo.usage = _usage;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.queueFamilyIndexCount = 0;
+        createInfo.pQueueFamilyIndices = nullptr;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-        vkResetFences(Device::Active->getVulkanDevice(), 1, &transferFence);
-        vkQueueSubmit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
-        
-        vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+        VkResult result = vkCreateImage(Device::Active->getVulkanDevice(), &createInfo, nullptr, &_vulkanImage);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create image. VkResult: " + std::to_string(result));
 
-        vkFreeCommandBuffers(Device::Active->getVulkanDevice(), Device::Active->getVulkanCommandPool(), 1, &commandBuffer);
-        vkDestroyFence(Device::Active->getVulkanDevice(), transferFence, nullptr);
-        
-        if (layout != VK_IMAGE_LAYOUT_UNDEFINED)
-            setLayout(layout);
-        
-        return TextureData(_size.x, _size.y, buffer.getData().data());
-    }
+        // Allocate memory for image
 
-    const uvec2& TextureArray::getSize() const
-    {
-        return _size;
-    }
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(Device::Active->getVulkanDevice(), _vulkanImage, &memRequirements);
 
-    VkImage TextureArray::getVulkanImage() const
-    {
-        return _vulkanImage;
+        MemoryAllocator* allocator = Device::Active->getMemoryAllocator();
+        uint32_t memoryType = allocator->findMemoryType(memRequirements.memoryTypeBits, MemoryUsage::GpuOnly);
+
+        MemoryCategory category = MemoryCategory::Texture;
+        if (_usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+            category = MemoryCategory::Attachment;
+
+        _imageMemory = allocator->allocate(memRequirements, memoryType, _tiling == VK_IMAGE_TILING_LINEAR, category, this);
+
+        vkBindImageMemory(Device::Active->getVulkanDevice(), _vulkanImage, _imageMemory.memory, _imageMemory.offset);
+        
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkImage successfully created and allocated." << std::endl;
+        #endif
     }
 
-    VkImageView TextureArray::getVulkanImageView(const TextureViewParameters& viewParameters) const
+    void TextureArray::relocate(VkCommandBuffer commandBuffer, RetiredResource& retiredResource)
     {
-        if (!_vulkanImageViews.count(viewParameters))
-        {
-            VkImageViewCreateInfo createInfo = viewParameters.getVulkanImageViewCreateInfo();
-            VkImageView view(VK_NULL_HANDLE);
+        retiredResource.image = _vulkanImage;
+        retiredResource.allocation = _imageMemory;
 
-            createInfo.image = _vulkanImage;
-            createInfo.format = _format;
+        createVulkanImage();
 
-            VkResult result = vkCreateImageView(Device::Active->getVulkanDevice(), &createInfo, nullptr, &view);
-            if (result != VK_SUCCESS)
-                throw std::runtime_error("Failed to create texture image view. VkResult: " + std::to_string(result));
+        // Cached views refer to the old image, they are recreated on demand and keep their pins
 
-            #ifndef NDEBUG
-            std::clog << "<S3DL Debug> VkImageView successfully created." << std::endl;
-            #endif
+        Device::Active->getImageViewCache()->moveImage(retiredResource.image, _vulkanImage, retiredResource.imageViews);
 
-            _vulkanImageViews.insert(std::pair<TextureViewParameters, VkImageView>({viewParameters, view}));
-        }
+        // Nothing to copy if the image was never written
 
-        return _vulkanImageViews.at(viewParameters);
-    }
+        std::vector<VkImageLayout> undefinedLayouts(_layouts.size(), VK_IMAGE_LAYOUT_UNDEFINED);
+        if (_layouts == undefinedLayouts)
+            return;
 
-    VkSampler TextureArray::getVulkanSampler() const
-    {
-        return _sampler->getVulkanSampler();
-    }
+        ImageBarrierBatch barriers;
+        addTransitions(barriers, retiredResource.image, _layouts, std::vector<VkImageLayout>(_layouts.size(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL));
+        addTransitions(barriers, _vulkanImage, undefinedLayouts, std::vector<VkImageLayout>(_layouts.size(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+        barriers.record(commandBuffer);
 
-    TextureArray::~TextureArray()
-    {
-        for (std::pair<const TextureViewParameters, VkImageView>& imageView: _vulkanImageViews)
+        // Copy every layer and level and put the new image back in the layout the old one was in
+
+        std::vector<VkImageCopy> copyInfos(_mipLevels);
+        for (uint32_t i = 0; i < _mipLevels; i++)
         {
-            if (imageView.second != VK_NULL_HANDLE)
-            {
-                vkDestroyImageView(Device::Active->getVulkanDevice(), imageView.second, nullptr);
-                #ifndef NDEBUG
-                std::clog << "<S3DL Debug> VkImageView successfully destroyed." << std::endl;
-                #endif
-            }
+            copyInfos[i].srcSubresource.aspectMask = getAvailableAspects(_format);
+            copyInfos[i].srcSubresource.mipLevel = i;
+            copyInfos[i].srcSubresource.baseArrayLayer = 0;
+            copyInfos[i].srcSubresource.layerCount = _layerCount;
+            copyInfos[i].srcOffset = {0, 0, 0};
+            copyInfos[i].dstSubresource = copyInfos[i].srcSubresource;
+            copyInfos[i].dstOffset = {0, 0, 0};
+            copyInfos[i].extent = {std::max(_size.x >> i, 1u), std::max(_size.y >> i, 1u), 1};
         }
 
-        if (_deleteSampler)
-            delete _sampler;
+        vkCmdCopyImage(commandBuffer, retiredResource.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copyInfos.size(), copyInfos.data());
 
-        if (_vulkanImageMemory != VK_NULL_HANDLE)
-            vkFreeMemory(Device::Active->getVulkanDevice(), _vulkanImageMemory, nullptr);
-        
-        if (_vulkanImage != VK_NULL_HANDLE)
-            vkDestroyImage(Device::Active->getVulkanDevice(), _vulkanImage, nullptr);
-        
-        #ifndef NDEBUG
-        std::clog << "<S3DL Debug> VkImage successfully freed and destroyed." << std::endl;
-        #endif
+        addTransitions(barriers, _vulkanImage, std::vector<VkImageLayout>(_layouts.size(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL), _layouts);
+        barriers.record(commandBuffer);
     }
 
     VkImageAspectFlags TextureArray::getAvailableAspects(VkFormat format)
@@ -672,28 +877,64 @@ namespace s3dl
         }
     }
 
-    Texture::Texture(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage) : TextureArray(size, format, tiling, usage, 1)
+    std::array<uint32_t, 2> TextureArray::resolveRange(std::array<uint32_t, 2> range, uint32_t count)
+    {
+        if (range[1] == VK_REMAINING_ARRAY_LAYERS)
+            range[1] = count;
+        if (range[0] > range[1] || range[1] > count)
+            throw std::runtime_error("Invalid subresource range [" + std::to_string(range[0]) + ", " + std::to_string(range[1]) + ") in " + std::to_string(count) + " subresources.");
+
+        return range;
+    }
+
+    VkFormat TextureArray::getCompressedTextureFormat(const CompressedTextureData& textureData)
+    {
+        // Devices without support for the format get the decoded texels instead, at four bytes per texel
+
+        if (CompressedTextureData::isFormatSupported(textureData.getFormat()))
+            return textureData.getFormat();
+        if (CompressedTextureData::isFormatDecodable(textureData.getFormat()))
+            return textureData.getDecodedFormat();
+
+        throw std::runtime_error("Compressed format " + std::to_string(textureData.getFormat()) + " is neither supported by the device nor decodable.");
+    }
+
+    Texture::Texture(const uvec2& size, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, bool mipmapped) : TextureArray(size, format, tiling, usage, 1, mipmapped)
+    {
+    }
+
+    Texture::Texture(const CompressedTextureData& textureData, VkImageUsageFlags usage) : TextureArray(textureData, usage, 1)
     {
     }
 
-    void Texture::fillFromTextureData(const TextureData& textureData)
+    void Texture::fillFromTextureData(const TextureData& textureData, TransferBatch* batch)
     {
-        TextureArray::fillFromTextureData(textureData, 0);
+        TextureArray::fillFromTextureData(textureData, 0, batch);
     }
 
-    void Texture::fillFromBuffer(const Buffer& buffer)
+    void Texture::fillFromBuffer(const Buffer& buffer, TransferBatch* batch, uint64_t bufferOffset)
     {
-        TextureArray::fillFromBuffer(buffer, 0, 1);
+        TextureArray::fillFromBuffer(buffer, 0, 1, batch, bufferOffset);
     }
 
-    void Texture::fillFromTextureArray(const TextureArray& textureArray, uint32_t srcLayer)
+    void Texture::fillFromTextureArray(const TextureArray& textureArray, uint32_t srcLayer, TransferBatch* batch)
     {
-        TextureArray::fillFromTextureArray(textureArray, srcLayer, 0, 1);
+        TextureArray::fillFromTextureArray(textureArray, srcLayer, 0, 1, batch);
     }
 
-    void Texture::fillFromTexture(const Texture& texture)
+    void Texture::fillFromTexture(const Texture& texture, TransferBatch* batch)
     {
-        TextureArray::fillFromTexture(texture, 0);
+        TextureArray::fillFromTexture(texture, 0, batch);
+    }
+
+    void Texture::fillFromCompressedTextureData(const CompressedTextureData& textureData, TransferBatch* batch)
+    {
+        TextureArray::fillFromCompressedTextureData(textureData, 0, 0, 1, batch);
+    }
+
+    void Texture::generateMipmaps(TransferBatch* batch)
+    {
+        TextureArray::generateMipmaps(batch);
     }
 
     void Texture::setSampler(const TextureSampler& sampler)
@@ -701,14 +942,29 @@ namespace s3dl
         TextureArray::setSampler(sampler);
     }
 
-    void Texture::updateLayoutState(VkImageLayout layout) const
+    void Texture::updateLayoutState(VkImageLayout layout, std::array<uint32_t, 2> mipRange) const
+    {
+        TextureArray::updateLayoutState(layout, {0, 1}, mipRange);
+    }
+
+    void Texture::setLayout(VkImageLayout layout, TransferBatch* batch) const
+    {
+        TextureArray::setLayout(layout, batch);
+    }
+
+    void Texture::setLayout(VkImageLayout layout, ImageBarrierBatch& barriers, std::array<uint32_t, 2> mipRange) const
+    {
+        TextureArray::setLayout(layout, barriers, {0, 1}, mipRange);
+    }
+
+    void Texture::setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout, std::array<uint32_t, 2> mipRange) const
     {
-        TextureArray::updateLayoutState(layout);
+        TextureArray::setLayout(commandBuffer, layout, {0, 1}, mipRange);
     }
 
-    void Texture::setLayout(VkImageLayout layout) const
+    VkImageLayout Texture::getLayout(uint32_t mipLevel) const
     {
-        TextureArray::setLayout(layout);
+        return TextureArray::getLayout(0, mipLevel);
     }
 
     VkFormat Texture::getFormat() const
@@ -721,11 +977,26 @@ namespace s3dl
         return TextureArray::getTextureData(0);
     }
 
+    ReadbackHandle Texture::getTextureDataAsync(RenderTarget& target) const
+    {
+        return TextureArray::getTextureDataAsync(target, 0);
+    }
+
+    ReadbackHandle Texture::getTextureDataAsync(TransferBatch& batch) const
+    {
+        return TextureArray::getTextureDataAsync(batch, 0);
+    }
+
     const uvec2& Texture::getSize() const
     {
         return TextureArray::getSize();
     }
 
+    uint32_t Texture::getMipLevels() const
+    {
+        return TextureArray::getMipLevels();
+    }
+
     VkImage Texture::getVulkanImage() const
     {
         return TextureArray::getVulkanImage();
@@ -736,6 +1007,16 @@ namespace s3dl
         return TextureArray::getVulkanImageView(viewParameters);
     }
 
+    ImageViewPinHandle Texture::pinVulkanImageView(const TextureViewParameters& viewParameters) const
+    {
+        return TextureArray::pinVulkanImageView(viewParameters);
+    }
+
+    void Texture::prewarmVulkanImageViews(const std::vector<TextureViewParameters>& viewParameters) const
+    {
+        TextureArray::prewarmVulkanImageViews(viewParameters);
+    }
+
     VkSampler Texture::getVulkanSampler() const
     {
         return TextureArray::getVulkanSampler();
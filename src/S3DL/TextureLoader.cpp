@@ -0,0 +1,366 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    TextureLoadRequest::TextureLoadRequest(const std::string& filename) :
+        _filename(filename),
+        _state(TextureLoadState::Queued),
+        _error(),
+        _size(0, 0),
+        _stagingBuffer(nullptr),
+        _texture(nullptr),
+        _ticket(0),
+        _queueStart(std::chrono::steady_clock::now()),
+        _uploadStart(),
+        _timings{}
+    {
+    }
+
+    const std::string& TextureLoadRequest::getFilename() const
+    {
+        return _filename;
+    }
+
+    TextureLoadState TextureLoadRequest::getState() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _state;
+    }
+
+    bool TextureLoadRequest::isReady() const
+    {
+        return getState() == TextureLoadState::Ready;
+    }
+
+    bool TextureLoadRequest::hasFailed() const
+    {
+        return getState() == TextureLoadState::Failed;
+    }
+
+    std::string TextureLoadRequest::getError() const
+    {
+        // Returned by copy, a worker may still be writing it
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _error;
+    }
+
+    Texture& TextureLoadRequest::getTexture()
+    {
+        if (!isReady())
+            throw std::runtime_error("Cannot access texture \"" + _filename + "\" before it is loaded.");
+
+        return *_texture;
+    }
+
+    const Texture& TextureLoadRequest::getTexture() const
+    {
+        if (!isReady())
+            throw std::runtime_error("Cannot access texture \"" + _filename + "\" before it is loaded.");
+
+        return *_texture;
+    }
+
+    TextureLoadTimings TextureLoadRequest::getTimings() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _timings;
+    }
+
+    TextureLoadRequest::~TextureLoadRequest()
+    {
+        if (_stagingBuffer != nullptr)
+            Device::Active->getStagingBufferPool()->release(_stagingBuffer);
+
+        if (_texture != nullptr)
+            delete _texture;
+    }
+
+    TextureLoader::TextureLoader(uint32_t threadCount, VkFormat format) :
+        _format(format),
+        _workers(),
+        _stopping(false),
+        _queuedRequests(),
+        _decodedRequests(),
+        _uploadingRequests(),
+        _decodingCount(0),
+        _totalTimings{}
+    {
+        threadCount = std::max(threadCount, 1u);
+        for (uint32_t i = 0; i < threadCount; i++)
+            _workers.emplace_back(&TextureLoader::decode, this);
+    }
+
+    TextureHandle TextureLoader::load(const std::string& filename)
+    {
+        TextureHandle request = std::make_shared<TextureLoadRequest>(filename);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queuedRequests.push_back(request);
+        }
+
+        _queueCondition.notify_one();
+
+        return request;
+    }
+
+    void TextureLoader::update()
+    {
+        std::deque<TextureHandle> decodedRequests;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            decodedRequests.swap(_decodedRequests);
+        }
+
+        // Create the textures decoded since the last update and record all their uploads in one batch. The loader lock is
+        // never taken while a request is locked, waiting threads lock them in the other order
+
+        UploadManager* uploadManager = Device::Active->getUploadManager();
+
+        std::vector<TextureHandle> uploadingRequests;
+        TextureLoadTimings timings{};
+
+        for (TextureHandle& request: decodedRequests)
+        {
+            std::lock_guard<std::mutex> lock(request->_mutex);
+
+            if (request->_state == TextureLoadState::Failed)
+            {
+                timings.queueTime += request->_timings.queueTime;
+                timings.decodeTime += request->_timings.decodeTime;
+                continue;
+            }
+
+            request->_texture = new Texture(request->_size, _format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+            request->_ticket = uploadManager->upload(*request->_texture, request->_stagingBuffer);
+            request->_stagingBuffer = nullptr;
+            request->_uploadStart = std::chrono::steady_clock::now();
+            request->_state = TextureLoadState::Uploading;
+
+            uploadingRequests.push_back(request);
+        }
+
+        if (!decodedRequests.empty())
+            uploadManager->flush();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _uploadingRequests.insert(_uploadingRequests.end(), uploadingRequests.begin(), uploadingRequests.end());
+            uploadingRequests = _uploadingRequests;
+        }
+
+        // Textures whose upload is complete are ready to be used, another thread updating concurrently may already have
+        // marked them
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        std::vector<TextureHandle> readyRequests;
+        for (TextureHandle& request: uploadingRequests)
+        {
+            if (!uploadManager->isComplete(request->_ticket))
+                continue;
+
+            std::lock_guard<std::mutex> lock(request->_mutex);
+
+            if (request->_state != TextureLoadState::Uploading)
+                continue;
+
+            request->_timings.uploadTime = getElapsedTime(request->_uploadStart, now);
+            request->_state = TextureLoadState::Ready;
+
+            addTimings(timings, request->_timings);
+            readyRequests.push_back(request);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (TextureHandle& request: readyRequests)
+        {
+            std::vector<TextureHandle>::iterator it = std::find(_uploadingRequests.begin(), _uploadingRequests.end(), request);
+            if (it != _uploadingRequests.end())
+                _uploadingRequests.erase(it);
+        }
+
+        addTimings(_totalTimings, timings);
+    }
+
+    void TextureLoader::wait(const TextureHandle& handle)
+    {
+        while (true)
+        {
+            TextureLoadState state = handle->getState();
+
+            if (state == TextureLoadState::Ready || state == TextureLoadState::Failed)
+                return;
+
+            if (state == TextureLoadState::Uploading)
+                Device::Active->getUploadManager()->wait(handle->_ticket);
+            else if (state != TextureLoadState::Decoded)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _decodedCondition.wait(lock, [&handle]() {
+                    TextureLoadState state = handle->getState();
+                    return state == TextureLoadState::Decoded || state == TextureLoadState::Failed;
+                });
+            }
+
+            update();
+        }
+    }
+
+    void TextureLoader::waitIdle()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _decodedCondition.wait(lock, [this]() { return _queuedRequests.empty() && _decodingCount == 0; });
+        }
+
+        update();
+        Device::Active->getUploadManager()->waitIdle();
+        update();
+    }
+
+    uint32_t TextureLoader::getThreadCount() const
+    {
+        return _workers.size();
+    }
+
+    uint32_t TextureLoader::getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _queuedRequests.size() + _decodingCount + _decodedRequests.size() + _uploadingRequests.size();
+    }
+
+    TextureLoadTimings TextureLoader::getTotalTimings() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _totalTimings;
+    }
+
+    TextureLoader::~TextureLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+
+        _queueCondition.notify_all();
+        for (std::thread& worker: _workers)
+            worker.join();
+
+        // Requests no worker started are abandoned, those already decoded are still uploaded
+
+        for (TextureHandle& request: _queuedRequests)
+        {
+            std::lock_guard<std::mutex> lock(request->_mutex);
+            request->_state = TextureLoadState::Failed;
+            request->_error = "Texture loader destroyed before \"" + request->_filename + "\" was loaded.";
+        }
+
+        _queuedRequests.clear();
+
+        update();
+        Device::Active->getUploadManager()->waitIdle();
+        update();
+    }
+
+    float TextureLoader::getElapsedTime(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+    {
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    void TextureLoader::addTimings(TextureLoadTimings& totalTimings, const TextureLoadTimings& timings)
+    {
+        totalTimings.queueTime += timings.queueTime;
+        totalTimings.decodeTime += timings.decodeTime;
+        totalTimings.stagingTime += timings.stagingTime;
+        totalTimings.uploadTime += timings.uploadTime;
+    }
+
+    void TextureLoader::decode()
+    {
+        while (true)
+        {
+            TextureHandle request;
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _queueCondition.wait(lock, [this]() { return _stopping || !_queuedRequests.empty(); });
+
+                if (_stopping)
+                    return;
+
+                request = _queuedRequests.front();
+                _queuedRequests.pop_front();
+                _decodingCount++;
+            }
+
+            std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
+
+            {
+                std::lock_guard<std::mutex> lock(request->_mutex);
+                request->_state = TextureLoadState::Decoding;
+                request->_timings.queueTime = getElapsedTime(request->_queueStart, decodeStart);
+            }
+
+            // Decode on this thread and copy the pixels right away into pooled staging memory
+
+            int width, height;
+            unsigned char* pixels = stbi_load(request->_filename.c_str(), &width, &height, nullptr, 4);
+            std::chrono::steady_clock::time_point stagingStart = std::chrono::steady_clock::now();
+
+            Buffer* stagingBuffer = nullptr;
+            std::string error;
+
+            if (pixels == nullptr)
+                error = "Failed to decode texture \"" + request->_filename + "\": " + stbi_failure_reason();
+            else
+            {
+                try
+                {
+                    StagingBuffer ownedStagingBuffer(width * height * 4, MemoryUsage::Upload);
+                    ownedStagingBuffer->setData(pixels, width * height * 4);
+                    stagingBuffer = ownedStagingBuffer.detach();
+                }
+                catch (const std::exception& exception)
+                {
+                    error = exception.what();
+                }
+
+                stbi_image_free(pixels);
+            }
+
+            std::chrono::steady_clock::time_point stagingEnd = std::chrono::steady_clock::now();
+
+            {
+                std::lock_guard<std::mutex> lock(request->_mutex);
+
+                request->_timings.decodeTime = getElapsedTime(decodeStart, stagingStart);
+                request->_timings.stagingTime = getElapsedTime(stagingStart, stagingEnd);
+
+                if (error.empty())
+                {
+                    request->_size = {(unsigned int) width, (unsigned int) height};
+                    request->_stagingBuffer = stagingBuffer;
+                    request->_state = TextureLoadState::Decoded;
+                }
+                else
+                {
+                    request->_error = error;
+                    request->_state = TextureLoadState::Failed;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _decodedRequests.push_back(request);
+                _decodingCount--;
+            }
+
+            _decodedCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,272 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    TextureResidency StreamedTexture::getResidency() const
+    {
+        return _residency;
+    }
+
+    uint32_t StreamedTexture::getResidentMipLevel() const
+    {
+        return _residentMipLevel;
+    }
+
+    uint32_t StreamedTexture::getMipLevels() const
+    {
+        return _levelUploads.size();
+    }
+
+    StreamedTexture::~StreamedTexture()
+    {
+    }
+
+    StreamedTexture::StreamedTexture(Texture& texture, const TextureSampler& sampler) :
+        _texture(&texture),
+        _sampler(sampler),
+        _residency(TextureResidency::Streaming),
+        _residentMipLevel(0),
+        _levelUploads()
+    {
+    }
+
+    const uint32_t TextureStreamer::DEFAULT_IMMEDIATE_SIZE;
+
+    TextureStreamer::TextureStreamer(uint32_t immediateSize) :
+        _immediateSize(immediateSize),
+        _streamingTextures(),
+        _statistics{}
+    {
+    }
+
+    StreamedTextureHandle TextureStreamer::stream(Texture& texture, const TextureData& textureData, int32_t priority, const TextureSampler& sampler)
+    {
+        TextureArray& textureArray = static_cast<TextureArray&>(texture);
+
+        if (textureData.size().x != textureArray._size.x || textureData.size().y != textureArray._size.y)
+            throw std::runtime_error("Cannot stream texture data of size " + std::to_string(textureData.size().x) + "x" + std::to_string(textureData.size().y) + " into texture of size " + std::to_string(textureArray._size.x) + "x" + std::to_string(textureArray._size.y) + ".");
+
+        std::vector<TextureData> mipChain = generateMipChain(textureData, textureArray._mipLevels);
+
+        // Levels no larger than the immediate size are uploaded right away, the coarsest one at least, so that the
+        // texture can be sampled from the next frame on
+
+        uint32_t immediateSize = getImmediateSize();
+        uint32_t firstImmediateLevel = mipChain.size() - 1;
+        while (firstImmediateLevel > 0 && std::max(mipChain[firstImmediateLevel - 1].size().x, mipChain[firstImmediateLevel - 1].size().y) <= immediateSize)
+            firstImmediateLevel--;
+
+        // Levels that are not resident yet are never sampled, but descriptors cover the whole mip chain so they must
+        // already be in a layout shaders can read
+
+        bool undefinedLevels = false;
+        for (uint32_t level = 0; level < mipChain.size(); level++)
+            if (textureArray.getLayout(0, level) == VK_IMAGE_LAYOUT_UNDEFINED)
+                undefinedLevels = true;
+
+        if (undefinedLevels)
+            textureArray.setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        uint64_t immediateBytes = 0;
+        for (uint32_t level = mipChain.size(); level > firstImmediateLevel; level--)
+        {
+            const TextureData& levelData = mipChain[level - 1];
+
+            StagingBuffer stagingBuffer(levelData.getRawSize(), MemoryUsage::Upload);
+            stagingBuffer->setData(levelData.getRawData(), levelData.getRawSize());
+
+            Device::Active->getUploadManager()->uploadMipLevel(textureArray, stagingBuffer.detach(), 0, level - 1);
+            immediateBytes += levelData.getRawSize();
+        }
+
+        // Finer levels go through the upload scheduler and its frame budget, coarsest first so that the LOD clamp can
+        // relax one level at a time
+
+        StreamedTextureHandle handle(new StreamedTexture(texture, sampler));
+        handle->_residentMipLevel = firstImmediateLevel;
+        handle->_levelUploads.resize(mipChain.size());
+
+        for (uint32_t level = firstImmediateLevel; level > 0; level--)
+        {
+            const TextureData& levelData = mipChain[level - 1];
+            handle->_levelUploads[level - 1] = Device::Active->getUploadScheduler()->scheduleMipLevel(textureArray, levelData.getRawData(), levelData.getRawSize(), 0, level - 1, priority);
+        }
+
+        clampSampler(*handle);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _statistics.streamedBytes += immediateBytes;
+
+        if (firstImmediateLevel == 0)
+            handle->_residency = TextureResidency::Resident;
+        else
+            _streamingTextures.push_back(handle);
+
+        return handle;
+    }
+
+    void TextureStreamer::cancel(const StreamedTextureHandle& texture)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<StreamedTextureHandle>::iterator it = std::find(_streamingTextures.begin(), _streamingTextures.end(), texture);
+        if (it == _streamingTextures.end())
+            return;
+
+        // Levels already submitted are still written but the texture keeps sampling from its current resident level
+
+        cancelUploads(*texture);
+        _streamingTextures.erase(it);
+    }
+
+    void TextureStreamer::cancel(const TextureArray& textureArray)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // The texture is being destroyed, the streamer must not touch it anymore
+
+        std::vector<StreamedTextureHandle> remainingTextures;
+        for (StreamedTextureHandle& texture: _streamingTextures)
+        {
+            if (static_cast<const TextureArray*>(texture->_texture) != &textureArray)
+            {
+                remainingTextures.push_back(texture);
+                continue;
+            }
+
+            cancelUploads(*texture);
+            texture->_texture = nullptr;
+        }
+
+        _streamingTextures.swap(remainingTextures);
+    }
+
+    void TextureStreamer::update()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<StreamedTextureHandle> remainingTextures;
+        for (StreamedTextureHandle& texture: _streamingTextures)
+        {
+            // Only a contiguous run of levels from the coarsest one can be sampled, a finer level that completed before
+            // a coarser one waits for it
+
+            uint32_t residentMipLevel = texture->_residentMipLevel;
+            while (texture->_residentMipLevel > 0 && texture->_levelUploads[texture->_residentMipLevel - 1]->isComplete())
+            {
+                texture->_residentMipLevel--;
+                _statistics.streamedBytes += texture->_levelUploads[texture->_residentMipLevel]->getSize();
+                texture->_levelUploads[texture->_residentMipLevel] = nullptr;
+            }
+
+            if (texture->_residentMipLevel != residentMipLevel)
+                clampSampler(*texture);
+
+            if (texture->_residentMipLevel == 0)
+                texture->_residency = TextureResidency::Resident;
+            else
+                remainingTextures.push_back(texture);
+        }
+
+        _streamingTextures.swap(remainingTextures);
+    }
+
+    void TextureStreamer::setImmediateSize(uint32_t immediateSize)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _immediateSize = immediateSize;
+    }
+
+    uint32_t TextureStreamer::getImmediateSize() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _immediateSize;
+    }
+
+    TextureStreamerStatistics TextureStreamer::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        TextureStreamerStatistics statistics = _statistics;
+        statistics.streamingTextures = _streamingTextures.size();
+        statistics.pendingLevels = 0;
+
+        for (const StreamedTextureHandle& texture: _streamingTextures)
+            statistics.pendingLevels += texture->_residentMipLevel;
+
+        return statistics;
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // Levels still queued are dropped with the scheduler, the textures keep their current LOD clamp
+
+        _streamingTextures.clear();
+    }
+
+    std::vector<TextureData> TextureStreamer::generateMipChain(const TextureData& textureData, uint32_t mipLevels)
+    {
+        // Each level is a 2x2 box filter of the previous one, the last row or column is repeated on odd sizes
+
+        std::vector<TextureData> mipChain(1, textureData);
+        mipChain.reserve(mipLevels);
+
+        for (uint32_t level = 1; level < mipLevels; level++)
+        {
+            const TextureData& source = mipChain.back();
+            uvec2 sourceSize = source.size();
+            uvec2 size = {std::max(sourceSize.x / 2, 1u), std::max(sourceSize.y / 2, 1u)};
+
+            const unsigned char* sourceData = source.getRawData();
+            std::vector<unsigned char> data(size.x * size.y * 4);
+
+            for (uint32_t y = 0; y < size.y; y++)
+            {
+                uint32_t y0 = std::min(2 * y, sourceSize.y - 1);
+                uint32_t y1 = std::min(2 * y + 1, sourceSize.y - 1);
+
+                for (uint32_t x = 0; x < size.x; x++)
+                {
+                    uint32_t x0 = std::min(2 * x, sourceSize.x - 1);
+                    uint32_t x1 = std::min(2 * x + 1, sourceSize.x - 1);
+
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        uint32_t sum = sourceData[(y0 * sourceSize.x + x0) * 4 + c] + sourceData[(y0 * sourceSize.x + x1) * 4 + c]
+                                     + sourceData[(y1 * sourceSize.x + x0) * 4 + c] + sourceData[(y1 * sourceSize.x + x1) * 4 + c];
+
+                        data[(y * size.x + x) * 4 + c] = (sum + 2) / 4;
+                    }
+                }
+            }
+
+            mipChain.push_back(TextureData(size.x, size.y, data.data()));
+        }
+
+        return mipChain;
+    }
+
+    void TextureStreamer::cancelUploads(StreamedTexture& texture)
+    {
+        for (ScheduledUploadHandle& upload: texture._levelUploads)
+            if (upload != nullptr)
+                Device::Active->getUploadScheduler()->cancel(upload);
+
+        texture._levelUploads.assign(texture._levelUploads.size(), nullptr);
+        texture._residency = TextureResidency::Cancelled;
+    }
+
+    void TextureStreamer::clampSampler(StreamedTexture& texture)
+    {
+        // The caller's LOD range is kept, only its lower bound is raised to the finest resident level. Textures at the
+        // same level share their sampler through the cache
+
+        const VkSamplerCreateInfo& createInfo = texture._sampler.getVulkanSamplerCreateInfo();
+
+        TextureSampler sampler(texture._sampler);
+        sampler.setLodRange(std::max(createInfo.minLod, static_cast<float>(texture._residentMipLevel)), createInfo.maxLod, createInfo.mipLodBias);
+
+        texture._texture->setSampler(sampler);
+    }
+}
@@ -0,0 +1,159 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const uint64_t TransferBatch::STAGING_CHUNK_SIZE;
+    const uint64_t TransferBatch::STAGING_ALIGNMENT;
+
+    TransferBatch::TransferBatch() :
+        _commandBuffer(VK_NULL_HANDLE),
+        _commandBufferOwner(),
+        _stagingBuffers(),
+        _stagingOffset(0),
+        _readbacks(),
+        _retiredBuffers()
+    {
+    }
+
+    std::pair<const Buffer*, uint64_t> TransferBatch::stage(const void* data, uint64_t size)
+    {
+        // Pack the data of every copy in shared staging buffers, aligned for any texel size up to 16 bytes
+
+        uint64_t offset = (_stagingOffset + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+
+        if (_stagingBuffers.empty() || offset + size > _stagingBuffers.back()->getSize())
+        {
+            StagingBuffer stagingBuffer(std::max(size, STAGING_CHUNK_SIZE), MemoryUsage::Upload);
+            _stagingBuffers.push_back(stagingBuffer.get());
+            stagingBuffer.detach();
+            offset = 0;
+        }
+
+        _stagingBuffers.back()->setData(data, size, offset);
+        _stagingOffset = offset + size;
+
+        return {_stagingBuffers.back(), offset};
+    }
+
+    VkCommandBuffer TransferBatch::getVulkanCommandBuffer()
+    {
+        if (_commandBuffer != VK_NULL_HANDLE)
+            return _commandBuffer;
+
+        // Recorded in the pool of the calling thread, so batches of different threads can be recorded concurrently. The
+        // batch may be submitted or dropped by another thread, the command buffer still goes back to that pool
+
+        _commandBuffer = Device::Active->acquireTransientCommandBuffer();
+        _commandBufferOwner = std::this_thread::get_id();
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkResult result = vkBeginCommandBuffer(_commandBuffer, &beginInfo);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to start recording command buffer for transfer batch. VkResult: " + std::to_string(result));
+
+        return _commandBuffer;
+    }
+
+    bool TransferBatch::isEmpty() const
+    {
+        return _commandBuffer == VK_NULL_HANDLE;
+    }
+
+    void TransferBatch::submit()
+    {
+        if (_commandBuffer != VK_NULL_HANDLE)
+        {
+            VkResult result = vkEndCommandBuffer(_commandBuffer);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to end recording command buffer for transfer batch. VkResult: " + std::to_string(result));
+
+            // Submit every recorded command at once and wait for them with a fence
+
+            VkFence transferFence = Device::Active->getSyncObjectPool()->acquireFence();
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &_commandBuffer;
+
+            result = Device::Active->submit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, transferFence);
+            if (result != VK_SUCCESS)
+            {
+                // Nothing was submitted, the fence would never be signaled
+
+                Device::Active->releaseTransientCommandBuffer(_commandBuffer, _commandBufferOwner);
+                Device::Active->getSyncObjectPool()->releaseFence(transferFence);
+                _commandBuffer = VK_NULL_HANDLE;
+
+                throw std::runtime_error("Failed to submit transfer batch command buffer. VkResult: " + std::to_string(result));
+            }
+
+            result = vkWaitForFences(Device::Active->getVulkanDevice(), 1, &transferFence, VK_TRUE, UINT64_MAX);
+            if (result != VK_SUCCESS)
+            {
+                // The command buffer may still be pending, it is left to the destruction of its pool
+
+                _commandBuffer = VK_NULL_HANDLE;
+                throw std::runtime_error("Failed to wait for transfer batch. VkResult: " + std::to_string(result));
+            }
+
+            Device::Active->releaseTransientCommandBuffer(_commandBuffer, _commandBufferOwner);
+            Device::Active->getSyncObjectPool()->releaseFence(transferFence);
+
+            _commandBuffer = VK_NULL_HANDLE;
+        }
+
+        // The batch has been waited for, its readbacks can be read
+
+        for (ReadbackHandle& readback: _readbacks)
+            readback->_complete = true;
+
+        _readbacks.clear();
+
+        releaseResources();
+    }
+
+    void TransferBatch::addReadback(const ReadbackHandle& readback)
+    {
+        _readbacks.push_back(readback);
+    }
+
+    void TransferBatch::retire(Buffer* buffer)
+    {
+        _retiredBuffers.push_back(buffer);
+    }
+
+    void TransferBatch::releaseResources()
+    {
+        // The staging data has been consumed or dropped, give the buffers back to the pool
+
+        for (Buffer* stagingBuffer: _stagingBuffers)
+            Device::Active->getStagingBufferPool()->release(stagingBuffer);
+
+        _stagingBuffers.clear();
+        _stagingOffset = 0;
+
+        // Buffers replaced while recording are not read by the batch anymore
+
+        for (Buffer* buffer: _retiredBuffers)
+            delete buffer;
+
+        _retiredBuffers.clear();
+    }
+
+    TransferBatch::~TransferBatch()
+    {
+        // Batches are submitted explicitly, one destroyed before that, typically while an exception unwinds, is dropped
+        // without submitting its partially recorded commands
+
+        if (_commandBuffer != VK_NULL_HANDLE)
+            Device::Active->releaseTransientCommandBuffer(_commandBuffer, _commandBufferOwner);
+
+        _readbacks.clear();
+
+        releaseResources();
+    }
+}
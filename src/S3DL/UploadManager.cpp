@@ -0,0 +1,491 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    UploadManager::UploadManager() :
+        _transferCommandPool(VK_NULL_HANDLE),
+        _graphicsCommandPool(VK_NULL_HANDLE),
+        _nextTicket(1),
+        _recording(false),
+        _currentBatch{},
+        _pendingBatches()
+    {
+    }
+
+    UploadTicket UploadManager::upload(Buffer& buffer, const void* data, uint64_t size, uint64_t offset)
+    {
+        if (offset + size > buffer._size)
+            throw std::runtime_error("Cannot upload " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes in buffer of size " + std::to_string(buffer._size) + " bytes.");
+
+        // Fill a pooled staging buffer, it is given back once the batch is complete
+
+        StagingBuffer stagingBuffer(size, MemoryUsage::Upload);
+        stagingBuffer->setData(data, size, 0);
+
+        return upload(buffer, stagingBuffer.detach(), size, offset);
+    }
+
+    UploadTicket UploadManager::upload(Buffer& buffer, Buffer* stagingBuffer, uint64_t size, uint64_t offset)
+    {
+        // The staging buffer goes back to the pool if the upload cannot be recorded
+
+        StagingBuffer ownedStagingBuffer(stagingBuffer);
+
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        if (offset + size > buffer._size || size > stagingBuffer->_size)
+            throw std::runtime_error("Cannot upload " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes in buffer of size " + std::to_string(buffer._size) + " bytes.");
+        if (!(buffer._usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+            throw std::runtime_error("Cannot upload to a buffer created without VK_BUFFER_USAGE_TRANSFER_DST_BIT.");
+
+        beginBatch();
+
+        // The staging buffer is owned by the batch from now on, it goes back to the pool once the batch is complete
+
+        _currentBatch.stagingBuffers.push_back(stagingBuffer);
+        ownedStagingBuffer.detach();
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = 0;
+        copyRegion.dstOffset = offset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(_currentBatch.transferCommandBuffer, stagingBuffer->_buffer, buffer._buffer, 1, &copyRegion);
+
+        // Hand the written range over to the graphics queue
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.buffer = buffer._buffer;
+        barrier.offset = offset;
+        barrier.size = size;
+
+        if (hasDedicatedTransferQueue())
+        {
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = Device::Active->getTransferQueueFamily();
+            barrier.dstQueueFamilyIndex = Device::Active->getGraphicsQueueFamily();
+
+            vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            _currentBatch.bufferAcquireBarriers.push_back(barrier);
+        }
+        else
+        {
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+
+        return _currentBatch.ticket;
+    }
+
+    UploadTicket UploadManager::upload(TextureArray& textureArray, const TextureData& textureData, uint32_t layer)
+    {
+        StagingBuffer stagingBuffer(textureData.getRawSize(), MemoryUsage::Upload);
+        stagingBuffer->setData(textureData.getRawData(), textureData.getRawSize());
+
+        return upload(textureArray, stagingBuffer.detach(), layer);
+    }
+
+    UploadTicket UploadManager::upload(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer)
+    {
+        return uploadTexture(textureArray, stagingBuffer, layer, 0, true);
+    }
+
+    UploadTicket UploadManager::uploadMipLevel(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer, uint32_t mipLevel)
+    {
+        return uploadTexture(textureArray, stagingBuffer, layer, mipLevel, false);
+    }
+
+    UploadTicket UploadManager::uploadTexture(TextureArray& textureArray, Buffer* stagingBuffer, uint32_t layer, uint32_t mipLevel, bool generateMipmaps)
+    {
+        // The staging buffer goes back to the pool if the upload cannot be recorded
+
+        StagingBuffer ownedStagingBuffer(stagingBuffer);
+
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        if (!(textureArray._usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+            throw std::runtime_error("Cannot upload to a texture created without VK_IMAGE_USAGE_TRANSFER_DST_BIT.");
+        if (layer >= textureArray._layerCount)
+            throw std::runtime_error("Cannot upload to layer " + std::to_string(layer) + " of texture array of " + std::to_string(textureArray._layerCount) + " layers.");
+        if (mipLevel >= textureArray._mipLevels)
+            throw std::runtime_error("Cannot upload to level " + std::to_string(mipLevel) + " of texture array of " + std::to_string(textureArray._mipLevels) + " levels.");
+
+        beginBatch();
+
+        // The staging buffer is owned by the batch from now on, it goes back to the pool once the batch is complete
+
+        _currentBatch.stagingBuffers.push_back(stagingBuffer);
+        ownedStagingBuffer.detach();
+
+        // The uploaded layer, or level of the layer, is entirely overwritten so its previous content can be discarded, the
+        // other subresources are left untouched
+
+        generateMipmaps = generateMipmaps && textureArray._mipLevels > 1;
+        uvec2 levelSize = {std::max(textureArray._size.x >> mipLevel, 1u), std::max(textureArray._size.y >> mipLevel, 1u)};
+
+        VkImageLayout finalLayout = textureArray.getLayout(layer, mipLevel);
+        if (finalLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+            finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = textureArray._vulkanImage;
+        barrier.subresourceRange.aspectMask = TextureArray::getAvailableAspects(textureArray._format);
+        barrier.subresourceRange.baseMipLevel = generateMipmaps ? 0 : mipLevel;
+        barrier.subresourceRange.levelCount = generateMipmaps ? textureArray._mipLevels : 1;
+        barrier.subresourceRange.baseArrayLayer = layer;
+        barrier.subresourceRange.layerCount = 1;
+
+        vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = mipLevel;
+        region.imageSubresource.baseArrayLayer = layer;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {levelSize.x, levelSize.y, 1};
+
+        vkCmdCopyBufferToImage(_currentBatch.transferCommandBuffer, stagingBuffer->_buffer, textureArray._vulkanImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        // Put the image back in its layout and hand it over to the graphics queue
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = finalLayout;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        if (hasDedicatedTransferQueue() && generateMipmaps)
+        {
+            // Blits need a graphics queue, the other levels are generated there once the image is acquired
+
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = Device::Active->getTransferQueueFamily();
+            barrier.dstQueueFamilyIndex = Device::Active->getGraphicsQueueFamily();
+
+            vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            _currentBatch.imageAcquireBarriers.push_back(barrier);
+
+            barrier.newLayout = finalLayout;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            _currentBatch.mipmapLayers.push_back({&textureArray, layer});
+            _currentBatch.mipmapBarriers.push_back(barrier);
+        }
+        else if (hasDedicatedTransferQueue())
+        {
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = Device::Active->getTransferQueueFamily();
+            barrier.dstQueueFamilyIndex = Device::Active->getGraphicsQueueFamily();
+
+            vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            _currentBatch.imageAcquireBarriers.push_back(barrier);
+        }
+        else
+        {
+            if (generateMipmaps)
+                textureArray.recordMipmapGeneration(_currentBatch.transferCommandBuffer, layer, 1);
+
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+            vkCmdPipelineBarrier(_currentBatch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+
+        if (generateMipmaps)
+            textureArray.updateLayoutState(finalLayout, {layer, layer + 1});
+        else
+            textureArray.updateLayoutState(finalLayout, {layer, layer + 1}, {mipLevel, mipLevel + 1});
+
+        return _currentBatch.ticket;
+    }
+
+    UploadTicket UploadManager::upload(Texture& texture, const TextureData& textureData)
+    {
+        return upload(static_cast<TextureArray&>(texture), textureData, 0);
+    }
+
+    UploadTicket UploadManager::upload(Texture& texture, Buffer* stagingBuffer)
+    {
+        return upload(static_cast<TextureArray&>(texture), stagingBuffer, 0);
+    }
+
+    void UploadManager::flush()
+    {
+        // Uploads may be recorded from any thread, the batches and the command pools of the manager are only touched
+        // under its lock
+
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        collectCompletedBatches();
+
+        if (!_recording)
+            return;
+
+        VkResult result = vkEndCommandBuffer(_currentBatch.transferCommandBuffer);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to end recording command buffer for upload. VkResult: " + std::to_string(result));
+
+        _currentBatch.fence = Device::Active->getSyncObjectPool()->acquireFence();
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &_currentBatch.transferCommandBuffer;
+
+        if (hasDedicatedTransferQueue())
+        {
+            // The copies run on the transfer queue and signal a semaphore
+
+            _currentBatch.semaphore = Device::Active->getSyncObjectPool()->acquireSemaphore();
+
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &_currentBatch.semaphore;
+
+            result = Device::Active->submit(Device::Active->getVulkanTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to submit upload command buffer. VkResult: " + std::to_string(result));
+
+            // The graphics queue waits for it and acquires the resources, every frame submitted afterwards sees the uploaded data.
+            // The command buffer comes from a pool of the manager, the device pool is used by the render thread
+
+            if (_graphicsCommandPool == VK_NULL_HANDLE)
+                _graphicsCommandPool = createCommandPool(Device::Active->getGraphicsQueueFamily());
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = _graphicsCommandPool;
+            allocInfo.commandBufferCount = 1;
+
+            result = vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &_currentBatch.graphicsCommandBuffer);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to allocate command buffer for upload. VkResult: " + std::to_string(result));
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            result = vkBeginCommandBuffer(_currentBatch.graphicsCommandBuffer, &beginInfo);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to start recording command buffer for upload. VkResult: " + std::to_string(result));
+
+            vkCmdPipelineBarrier(
+                _currentBatch.graphicsCommandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                0, nullptr,
+                _currentBatch.bufferAcquireBarriers.size(), _currentBatch.bufferAcquireBarriers.data(),
+                _currentBatch.imageAcquireBarriers.size(), _currentBatch.imageAcquireBarriers.data()
+            );
+
+            for (const std::pair<const TextureArray*, uint32_t>& mipmapLayer: _currentBatch.mipmapLayers)
+                mipmapLayer.first->recordMipmapGeneration(_currentBatch.graphicsCommandBuffer, mipmapLayer.second, 1);
+
+            if (!_currentBatch.mipmapBarriers.empty())
+            {
+                vkCmdPipelineBarrier(
+                    _currentBatch.graphicsCommandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    _currentBatch.mipmapBarriers.size(), _currentBatch.mipmapBarriers.data()
+                );
+            }
+
+            result = vkEndCommandBuffer(_currentBatch.graphicsCommandBuffer);
+            if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to end recording command buffer for upload. VkResult: " + std::to_string(result));
+
+            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            VkSubmitInfo acquireSubmitInfo{};
+            acquireSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            acquireSubmitInfo.waitSemaphoreCount = 1;
+            acquireSubmitInfo.pWaitSemaphores = &_currentBatch.semaphore;
+            acquireSubmitInfo.pWaitDstStageMask = &waitStage;
+            acquireSubmitInfo.commandBufferCount = 1;
+            acquireSubmitInfo.pCommandBuffers = &_currentBatch.graphicsCommandBuffer;
+
+            result = Device::Active->submit(Device::Active->getVulkanGraphicsQueue(), 1, &acquireSubmitInfo, _currentBatch.fence);
+        }
+        else
+            result = Device::Active->submit(Device::Active->getVulkanGraphicsQueue(), 1, &submitInfo, _currentBatch.fence);
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to submit upload command buffer. VkResult: " + std::to_string(result));
+
+        _pendingBatches.push_back(_currentBatch);
+        _currentBatch = {};
+        _recording = false;
+    }
+
+    bool UploadManager::isComplete(UploadTicket ticket)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        collectCompletedBatches();
+
+        if (_recording && ticket >= _currentBatch.ticket)
+            return false;
+
+        return _pendingBatches.empty() || ticket < _pendingBatches.front().ticket;
+    }
+
+    void UploadManager::wait(UploadTicket ticket)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        if (_recording && ticket >= _currentBatch.ticket)
+            flush();
+
+        // Batches complete in submission order, waiting for the last one covering the ticket is enough
+
+        for (std::deque<UploadBatch>::reverse_iterator it = _pendingBatches.rbegin(); it != _pendingBatches.rend(); it++)
+        {
+            if (it->ticket <= ticket)
+            {
+                vkWaitForFences(Device::Active->getVulkanDevice(), 1, &it->fence, VK_TRUE, UINT64_MAX);
+                break;
+            }
+        }
+
+        collectCompletedBatches();
+    }
+
+    void UploadManager::waitIdle()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        wait(_nextTicket - 1);
+    }
+
+    bool UploadManager::hasDedicatedTransferQueue() const
+    {
+        return Device::Active->getTransferQueueFamily() != Device::Active->getGraphicsQueueFamily();
+    }
+
+    UploadManager::~UploadManager()
+    {
+        waitIdle();
+
+        if (_transferCommandPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(Device::Active->getVulkanDevice(), _transferCommandPool, nullptr);
+
+            #ifndef NDEBUG
+            std::clog << "<S3DL Debug> VkCommandPool successfully destroyed." << std::endl;
+            #endif
+        }
+
+        if (_graphicsCommandPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(Device::Active->getVulkanDevice(), _graphicsCommandPool, nullptr);
+
+            #ifndef NDEBUG
+            std::clog << "<S3DL Debug> VkCommandPool successfully destroyed." << std::endl;
+            #endif
+        }
+    }
+
+    VkCommandPool UploadManager::createCommandPool(uint32_t queueFamily)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = queueFamily;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        VkCommandPool commandPool;
+        VkResult result = vkCreateCommandPool(Device::Active->getVulkanDevice(), &poolInfo, nullptr, &commandPool);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to create command pool. VkResult: " + std::to_string(result));
+
+        #ifndef NDEBUG
+        std::clog << "<S3DL Debug> VkCommandPool successfully created." << std::endl;
+        #endif
+
+        return commandPool;
+    }
+
+    void UploadManager::beginBatch()
+    {
+        if (_recording)
+            return;
+
+        VkResult result;
+
+        // The pool is created on first use, once the device is active
+
+        if (_transferCommandPool == VK_NULL_HANDLE)
+            _transferCommandPool = createCommandPool(Device::Active->getTransferQueueFamily());
+
+        _currentBatch = {};
+        _currentBatch.ticket = _nextTicket++;
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = _transferCommandPool;
+        allocInfo.commandBufferCount = 1;
+
+        result = vkAllocateCommandBuffers(Device::Active->getVulkanDevice(), &allocInfo, &_currentBatch.transferCommandBuffer);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate command buffer for upload. VkResult: " + std::to_string(result));
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        result = vkBeginCommandBuffer(_currentBatch.transferCommandBuffer, &beginInfo);
+        if (result != VK_SUCCESS)
+            throw std::runtime_error("Failed to start recording command buffer for upload. VkResult: " + std::to_string(result));
+
+        _recording = true;
+    }
+
+    void UploadManager::collectCompletedBatches()
+    {
+        while (!_pendingBatches.empty() && vkGetFenceStatus(Device::Active->getVulkanDevice(), _pendingBatches.front().fence) == VK_SUCCESS)
+        {
+            destroyBatch(_pendingBatches.front());
+            _pendingBatches.pop_front();
+        }
+    }
+
+    void UploadManager::destroyBatch(UploadBatch& batch)
+    {
+        for (Buffer* stagingBuffer: batch.stagingBuffers)
+            Device::Active->getStagingBufferPool()->release(stagingBuffer);
+
+        vkFreeCommandBuffers(Device::Active->getVulkanDevice(), _transferCommandPool, 1, &batch.transferCommandBuffer);
+        if (batch.graphicsCommandBuffer != VK_NULL_HANDLE)
+            vkFreeCommandBuffers(Device::Active->getVulkanDevice(), _graphicsCommandPool, 1, &batch.graphicsCommandBuffer);
+        if (batch.semaphore != VK_NULL_HANDLE)
+            Device::Active->getSyncObjectPool()->releaseSemaphore(batch.semaphore);
+
+        Device::Active->getSyncObjectPool()->releaseFence(batch.fence);
+    }
+}
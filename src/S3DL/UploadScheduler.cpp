@@ -0,0 +1,349 @@
+#include <S3DL/S3DL.hpp>
+
+namespace s3dl
+{
+    const uint64_t ScheduledUpload::NO_DEADLINE;
+
+    ScheduledUpload::ScheduledUpload(int32_t priority, uint64_t deadline, Buffer* stagingBuffer, uint64_t size) :
+        _priority(priority),
+        _deadline(deadline),
+        _order(0),
+        _stagingBuffer(stagingBuffer),
+        _size(size),
+        _buffer(nullptr),
+        _offset(0),
+        _textureArray(nullptr),
+        _layer(0),
+        _mipLevel(0),
+        _singleLevel(false),
+        _submitted(false),
+        _ticket(0)
+    {
+    }
+
+    int32_t ScheduledUpload::getPriority() const
+    {
+        return _priority;
+    }
+
+    uint64_t ScheduledUpload::getDeadline() const
+    {
+        return _deadline;
+    }
+
+    uint64_t ScheduledUpload::getSize() const
+    {
+        return _size;
+    }
+
+    bool ScheduledUpload::isSubmitted() const
+    {
+        return _submitted;
+    }
+
+    bool ScheduledUpload::isComplete() const
+    {
+        return _submitted && Device::Active->getUploadManager()->isComplete(_ticket);
+    }
+
+    UploadTicket ScheduledUpload::getTicket() const
+    {
+        if (!_submitted)
+            throw std::runtime_error("Cannot get the ticket of a scheduled upload that has not been submitted yet.");
+
+        return _ticket;
+    }
+
+    ScheduledUpload::~ScheduledUpload()
+    {
+        // Once submitted the staging buffer belongs to the upload manager, otherwise the upload was cancelled
+
+        if (_stagingBuffer != nullptr)
+            Device::Active->getStagingBufferPool()->release(_stagingBuffer);
+    }
+
+    const uint64_t UploadScheduler::DEFAULT_FRAME_BUDGET;
+
+    UploadScheduler::UploadScheduler(uint64_t frameBudget) :
+        _frameBudget(frameBudget),
+        _nextOrder(0),
+        _queuedUploads(),
+        _statistics{}
+    {
+    }
+
+    ScheduledUploadHandle UploadScheduler::schedule(Buffer& buffer, const void* data, uint64_t size, uint64_t offset, int32_t priority, uint64_t deadline)
+    {
+        if (offset + size > buffer.getSize())
+            throw std::runtime_error("Cannot upload " + std::to_string(size) + " bytes of data with offset of " + std::to_string(offset) + " bytes in buffer of size " + std::to_string(buffer.getSize()) + " bytes.");
+
+        // The data is staged right away so that the caller does not have to keep it alive until the upload is submitted
+
+        StagingBuffer stagingBuffer(size, MemoryUsage::Upload);
+        stagingBuffer->setData(data, size, 0);
+
+        ScheduledUpload* upload = new ScheduledUpload(priority, deadline, stagingBuffer.get(), size);
+        stagingBuffer.detach();
+        upload->_buffer = &buffer;
+        upload->_offset = offset;
+
+        return enqueue(upload);
+    }
+
+    ScheduledUploadHandle UploadScheduler::schedule(TextureArray& textureArray, const TextureData& textureData, uint32_t layer, int32_t priority, uint64_t deadline)
+    {
+        StagingBuffer stagingBuffer(textureData.getRawSize(), MemoryUsage::Upload);
+        stagingBuffer->setData(textureData.getRawData(), textureData.getRawSize());
+
+        ScheduledUpload* upload = new ScheduledUpload(priority, deadline, stagingBuffer.get(), textureData.getRawSize());
+        stagingBuffer.detach();
+        upload->_textureArray = &textureArray;
+        upload->_layer = layer;
+
+        return enqueue(upload);
+    }
+
+    ScheduledUploadHandle UploadScheduler::schedule(Texture& texture, const TextureData& textureData, int32_t priority, uint64_t deadline)
+    {
+        return schedule(static_cast<TextureArray&>(texture), textureData, 0, priority, deadline);
+    }
+
+    ScheduledUploadHandle UploadScheduler::scheduleMipLevel(TextureArray& textureArray, const void* data, uint64_t size, uint32_t layer, uint32_t mipLevel, int32_t priority, uint64_t deadline)
+    {
+        // Only this level is written, the other levels of the layer keep their content
+
+        StagingBuffer stagingBuffer(size, MemoryUsage::Upload);
+        stagingBuffer->setData(data, size, 0);
+
+        ScheduledUpload* upload = new ScheduledUpload(priority, deadline, stagingBuffer.get(), size);
+        stagingBuffer.detach();
+        upload->_textureArray = &textureArray;
+        upload->_layer = layer;
+        upload->_mipLevel = mipLevel;
+        upload->_singleLevel = true;
+
+        return enqueue(upload);
+    }
+
+    void UploadScheduler::cancel(const ScheduledUploadHandle& upload)
+    {
+        // Cancelled uploads are dropped once the lock is released, giving back their staging buffer may destroy a buffer,
+        // which cancels its own uploads
+
+        std::vector<ScheduledUploadHandle> cancelledUploads;
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<ScheduledUploadHandle>::iterator it = std::find(_queuedUploads.begin(), _queuedUploads.end(), upload);
+        if (it == _queuedUploads.end())
+            return;
+
+        _statistics.queueDepth--;
+        _statistics.queuedBytes -= upload->_size;
+
+        cancelledUploads.push_back(*it);
+        _queuedUploads.erase(it);
+    }
+
+    void UploadScheduler::cancel(const TextureArray& textureArray)
+    {
+        std::vector<ScheduledUploadHandle> cancelledUploads;
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<ScheduledUploadHandle> remainingUploads;
+        for (ScheduledUploadHandle& upload: _queuedUploads)
+        {
+            if (upload->_textureArray != &textureArray)
+            {
+                remainingUploads.push_back(upload);
+                continue;
+            }
+
+            _statistics.queueDepth--;
+            _statistics.queuedBytes -= upload->_size;
+            cancelledUploads.push_back(upload);
+        }
+
+        _queuedUploads.swap(remainingUploads);
+    }
+
+    void UploadScheduler::cancel(const Buffer& buffer)
+    {
+        std::vector<ScheduledUploadHandle> cancelledUploads;
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<ScheduledUploadHandle> remainingUploads;
+        for (ScheduledUploadHandle& upload: _queuedUploads)
+        {
+            if (upload->_buffer != &buffer)
+            {
+                remainingUploads.push_back(upload);
+                continue;
+            }
+
+            _statistics.queueDepth--;
+            _statistics.queuedBytes -= upload->_size;
+            cancelledUploads.push_back(upload);
+        }
+
+        _queuedUploads.swap(remainingUploads);
+    }
+
+    void UploadScheduler::update(uint64_t frame)
+    {
+        std::vector<ScheduledUploadHandle> uploads;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            uploads = selectUploads(_queuedUploads, frame, _frameBudget, _statistics);
+        }
+
+        // Submitted without the lock, the upload manager may give back staging buffers, and destroying a buffer cancels
+        // its uploads
+
+        for (ScheduledUploadHandle& upload: uploads)
+            submit(*upload);
+    }
+
+    void UploadScheduler::flush()
+    {
+        std::vector<ScheduledUploadHandle> uploads;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::sort(_queuedUploads.begin(), _queuedUploads.end(), isBefore);
+
+            for (ScheduledUploadHandle& upload: _queuedUploads)
+                dequeue(*upload, _statistics);
+
+            uploads.swap(_queuedUploads);
+        }
+
+        for (ScheduledUploadHandle& upload: uploads)
+            submit(*upload);
+    }
+
+    void UploadScheduler::setFrameBudget(uint64_t frameBudget)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _frameBudget = frameBudget;
+    }
+
+    uint64_t UploadScheduler::getFrameBudget() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _frameBudget;
+    }
+
+    UploadSchedulerStatistics UploadScheduler::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _statistics;
+    }
+
+    UploadScheduler::~UploadScheduler()
+    {
+        // Queued uploads are dropped, their staging buffers go back to the pool with the last handle
+
+        std::vector<ScheduledUploadHandle> queuedUploads;
+        queuedUploads.swap(_queuedUploads);
+    }
+
+    std::vector<ScheduledUploadHandle> UploadScheduler::selectUploads(std::vector<ScheduledUploadHandle>& queuedUploads, uint64_t frame, uint64_t frameBudget, UploadSchedulerStatistics& statistics)
+    {
+        std::vector<ScheduledUploadHandle> uploads;
+
+        statistics.uploadsLastFrame = 0;
+        statistics.bytesLastFrame = 0;
+
+        std::sort(queuedUploads.begin(), queuedUploads.end(), isBefore);
+
+        // Uploads that reached their deadline go out whatever the budget
+
+        std::vector<ScheduledUploadHandle> remainingUploads;
+        for (ScheduledUploadHandle& upload: queuedUploads)
+        {
+            if (upload->_deadline <= frame)
+            {
+                if (upload->_deadline < frame)
+                    statistics.missedDeadlines++;
+
+                dequeue(*upload, statistics);
+                uploads.push_back(upload);
+            }
+            else
+                remainingUploads.push_back(upload);
+        }
+
+        // The others are taken by priority until the budget is spent, an upload larger than the whole budget goes alone
+        // in its frame rather than never at all
+
+        uint32_t i = 0;
+        for (; i < remainingUploads.size(); i++)
+        {
+            if (statistics.bytesLastFrame != 0 && statistics.bytesLastFrame + remainingUploads[i]->_size > frameBudget)
+                break;
+
+            dequeue(*remainingUploads[i], statistics);
+            uploads.push_back(remainingUploads[i]);
+        }
+
+        queuedUploads.assign(remainingUploads.begin() + i, remainingUploads.end());
+
+        return uploads;
+    }
+
+    bool UploadScheduler::isBefore(const ScheduledUploadHandle& a, const ScheduledUploadHandle& b)
+    {
+        if (a->_priority != b->_priority)
+            return a->_priority > b->_priority;
+        if (a->_deadline != b->_deadline)
+            return a->_deadline < b->_deadline;
+
+        return a->_order < b->_order;
+    }
+
+    ScheduledUploadHandle UploadScheduler::enqueue(ScheduledUpload* upload)
+    {
+        ScheduledUploadHandle handle(upload);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        upload->_order = _nextOrder++;
+        _queuedUploads.push_back(handle);
+
+        _statistics.queueDepth++;
+        _statistics.queuedBytes += upload->_size;
+
+        return handle;
+    }
+
+    void UploadScheduler::dequeue(ScheduledUpload& upload, UploadSchedulerStatistics& statistics)
+    {
+        // Called under the lock for every upload about to be submitted
+
+        statistics.queueDepth--;
+        statistics.queuedBytes -= upload._size;
+
+        statistics.uploadsLastFrame++;
+        statistics.bytesLastFrame += upload._size;
+        statistics.totalBytes += upload._size;
+    }
+
+    void UploadScheduler::submit(ScheduledUpload& upload)
+    {
+        // The upload manager takes the staging buffer, even if the upload fails
+
+        Buffer* stagingBuffer = upload._stagingBuffer;
+        upload._stagingBuffer = nullptr;
+
+        if (upload._buffer != nullptr)
+            upload._ticket = Device::Active->getUploadManager()->upload(*upload._buffer, stagingBuffer, upload._size, upload._offset);
+        else if (upload._singleLevel)
+            upload._ticket = Device::Active->getUploadManager()->uploadMipLevel(*upload._textureArray, stagingBuffer, upload._layer, upload._mipLevel);
+        else
+            upload._ticket = Device::Active->getUploadManager()->upload(*upload._textureArray, stagingBuffer, upload._layer);
+
+        upload._submitted = true;
+    }
+}
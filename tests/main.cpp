@@ -1,10 +1,418 @@
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+
+#include <S3DL/S3DL.hpp>
+
+// None of these tests need a GPU, they exercise the parts of the library that only do bookkeeping on the CPU
+
+unsigned int failureCount = 0;
+
+void check(bool condition, const std::string& description)
+{
+    if (!condition)
+    {
+        std::cout << "FAILED: " << description << std::endl;
+        failureCount++;
+    }
+}
+
+bool isTexel(const s3dl::TextureData& textureData, unsigned int x, unsigned int y, const s3dl::Color& color)
+{
+    const s3dl::Color& texel = textureData(x, y);
+    return texel.x == color.x && texel.y == color.y && texel.z == color.z && texel.w == color.w;
+}
+
+s3dl::ScheduledUploadHandle makeUpload(int32_t priority, uint64_t deadline, uint64_t size)
+{
+    return s3dl::ScheduledUploadHandle(new s3dl::ScheduledUpload(priority, deadline, nullptr, size));
+}
+
+void writeUint(std::vector<uint8_t>& data, uint64_t offset, uint64_t value, uint32_t byteCount)
+{
+    for (uint32_t i = 0; i < byteCount; i++)
+        data[offset + i] = (value >> (8*i)) & 255;
+}
+
+s3dl::TextureData decodeBlocks(VkFormat format, uint32_t width, uint32_t height, const std::vector<uint8_t>& blocks)
+{
+    // Wrap the blocks in a minimal single level KTX2 file, the level index right after the header
+
+    std::vector<uint8_t> file(104, 0);
+    const uint8_t identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    std::copy(identifier, identifier + 12, file.begin());
+
+    writeUint(file, 12, format, 4);
+    writeUint(file, 16, 1, 4);
+    writeUint(file, 20, width, 4);
+    writeUint(file, 24, height, 4);
+    writeUint(file, 36, 1, 4);
+    writeUint(file, 40, 1, 4);
+    writeUint(file, 80, 104, 8);
+    writeUint(file, 88, blocks.size(), 8);
+    writeUint(file, 96, blocks.size(), 8);
+
+    file.insert(file.end(), blocks.begin(), blocks.end());
+
+    const std::string filename = "S3DLTests.ktx2";
+    std::ofstream stream(filename, std::ios::binary);
+    stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+    stream.close();
+
+    s3dl::TextureData textureData = s3dl::CompressedTextureData(filename).decode(0, 0);
+    std::remove(filename.c_str());
+
+    return textureData;
+}
+
+void checkBlock(VkFormat format, const std::vector<uint8_t>& block, const std::vector<uint8_t>& texels, const std::string& description)
+{
+    s3dl::TextureData textureData = decodeBlocks(format, 4, 4, block);
+    check(std::equal(texels.begin(), texels.end(), textureData.getRawData()), description);
+}
+
+void testMemoryAllocator()
+{
+    // First fit and splitting of the free ranges
+
+    s3dl::MemoryBlock block{};
+    block.size = 1024;
+    block.freeRanges[0] = 1024;
+
+    VkMemoryRequirements requirements{};
+    requirements.size = 256;
+    requirements.alignment = 1;
+
+    s3dl::MemoryAllocation a{}, b{}, c{};
+    check(s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, a) && a.offset == 0, "allocator: first allocation at offset 0");
+    check(s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, b) && b.offset == 256, "allocator: second allocation follows the first");
+    check(s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, c) && c.offset == 512, "allocator: third allocation follows the second");
+    check(block.allocationCount == 3 && block.bytesInUse == 768, "allocator: block usage after three allocations");
+    check(block.freeRanges.size() == 1 && block.freeRanges[768] == 256, "allocator: free range left after three allocations");
+
+    s3dl::MemoryAllocator::freeFromBlock(&block, b);
+    check(block.freeRanges.size() == 2 && block.freeRanges[256] == 256, "allocator: freed range is not merged with allocated neighbours");
+
+    s3dl::MemoryAllocation d{};
+    requirements.size = 128;
+    check(s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, d) && d.offset == 256, "allocator: first fit takes the lowest free range");
+    check(block.freeRanges[384] == 128, "allocator: remainder of a split range stays free");
+
+    // Coalescing with the next range, then with both neighbours at once
+
+    s3dl::MemoryAllocator::freeFromBlock(&block, d);
+    check(block.freeRanges.size() == 2 && block.freeRanges[256] == 256, "allocator: freed range merges with the next free range");
+
+    s3dl::MemoryAllocator::freeFromBlock(&block, a);
+    check(block.freeRanges.size() == 2 && block.freeRanges[0] == 512, "allocator: freed range merges with the next free range at offset 0");
+
+    s3dl::MemoryAllocator::freeFromBlock(&block, c);
+    check(block.freeRanges.size() == 1 && block.freeRanges[0] == 1024, "allocator: freed range merges with both neighbours");
+    check(block.allocationCount == 0 && block.bytesInUse == 0, "allocator: empty block after freeing everything");
+
+    // Alignment leaves a free range before the allocation, oversized requests fail
+
+    s3dl::MemoryAllocation e{}, f{};
+    requirements.size = 16;
+    s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, e);
+    requirements.alignment = 256;
+    check(s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, f) && f.offset == 256, "allocator: allocation is aligned");
+    check(block.freeRanges.size() == 2 && block.freeRanges[16] == 240 && block.freeRanges[272] == 752, "allocator: alignment padding stays free");
+
+    s3dl::MemoryAllocation g{};
+    requirements.size = 1024;
+    requirements.alignment = 1;
+    check(!s3dl::MemoryAllocator::allocateFromBlock(&block, requirements, g), "allocator: allocation larger than any free range fails");
+
+    // Resources over half a block get their own block
+
+    check(!s3dl::MemoryAllocator::requiresDedicatedBlock(s3dl::MemoryAllocator::BLOCK_SIZE / 2, s3dl::MemoryAllocator::BLOCK_SIZE), "allocator: half a block is sub-allocated");
+    check(s3dl::MemoryAllocator::requiresDedicatedBlock(s3dl::MemoryAllocator::BLOCK_SIZE / 2 + 1, s3dl::MemoryAllocator::BLOCK_SIZE), "allocator: more than half a block is dedicated");
+}
+
+void testStagingBufferPool()
+{
+    // Buckets are powers of two, at least MIN_BUCKET_SIZE
+
+    const uint64_t minBucketSize = s3dl::StagingBufferPool::MIN_BUCKET_SIZE;
+
+    check(s3dl::StagingBufferPool::getBucketSize(1) == minBucketSize, "staging pool: small sizes use the smallest bucket");
+    check(s3dl::StagingBufferPool::getBucketSize(minBucketSize) == minBucketSize, "staging pool: exact bucket size");
+    check(s3dl::StagingBufferPool::getBucketSize(minBucketSize + 1) == 2*minBucketSize, "staging pool: sizes round up to the next bucket");
+    check(s3dl::StagingBufferPool::getBucketSize(3*minBucketSize) == 4*minBucketSize, "staging pool: buckets are powers of two");
+
+    // Released buffers are only cached while the pool stays under its capacity
+
+    const uint64_t capacity = s3dl::StagingBufferPool::DEFAULT_CAPACITY;
+
+    check(s3dl::StagingBufferPool::fitsInCache(minBucketSize, 0, capacity), "staging pool: buffer fits in an empty pool");
+    check(s3dl::StagingBufferPool::fitsInCache(minBucketSize, capacity - minBucketSize, capacity), "staging pool: buffer filling the pool exactly is cached");
+    check(!s3dl::StagingBufferPool::fitsInCache(minBucketSize, capacity - minBucketSize + 1, capacity), "staging pool: buffer overflowing the pool is evicted");
+    check(!s3dl::StagingBufferPool::fitsInCache(0, capacity + 1, capacity), "staging pool: pool over capacity is trimmed");
+}
+
+void testUploadScheduler()
+{
+    const uint64_t noDeadline = s3dl::ScheduledUpload::NO_DEADLINE;
+
+    // Higher priorities first, then earlier deadlines
+
+    s3dl::UploadSchedulerStatistics statistics{};
+    std::vector<s3dl::ScheduledUploadHandle> queue = {makeUpload(0, noDeadline, 100), makeUpload(5, noDeadline, 100), makeUpload(2, 50, 100), makeUpload(2, 20, 100)};
+    std::vector<s3dl::ScheduledUploadHandle> expected = {queue[1], queue[3], queue[2], queue[0]};
+    statistics.queueDepth = 4;
+    statistics.queuedBytes = 400;
+
+    std::vector<s3dl::ScheduledUploadHandle> selected = s3dl::UploadScheduler::selectUploads(queue, 0, 1000, statistics);
+    check(selected == expected, "scheduler: uploads are ordered by priority then deadline");
+    check(queue.empty() && statistics.queueDepth == 0 && statistics.queuedBytes == 0, "scheduler: selected uploads leave the queue");
+    check(statistics.uploadsLastFrame == 4 && statistics.bytesLastFrame == 400, "scheduler: frame statistics");
+
+    // The frame budget stops the selection, but the first upload always goes through
+
+    statistics = {};
+    queue = {makeUpload(3, noDeadline, 400), makeUpload(2, noDeadline, 400), makeUpload(1, noDeadline, 400)};
+    expected = {queue[0], queue[1]};
+    statistics.queueDepth = 3;
+    statistics.queuedBytes = 1200;
+
+    selected = s3dl::UploadScheduler::selectUploads(queue, 0, 1000, statistics);
+    check(selected == expected, "scheduler: uploads over the frame budget wait");
+    check(queue.size() == 1 && statistics.queueDepth == 1 && statistics.queuedBytes == 400, "scheduler: waiting uploads stay queued");
+
+    statistics = {};
+    queue = {makeUpload(2, noDeadline, 5000), makeUpload(1, noDeadline, 10)};
+    expected = {queue[0]};
+    statistics.queueDepth = 2;
+    statistics.queuedBytes = 5010;
+
+    selected = s3dl::UploadScheduler::selectUploads(queue, 0, 1000, statistics);
+    check(selected == expected, "scheduler: an upload larger than the budget is not starved");
+
+    // Uploads due this frame go first whatever their priority and the budget, late ones are counted
+
+    statistics = {};
+    queue = {makeUpload(0, 10, 900), makeUpload(0, 5, 900), makeUpload(9, noDeadline, 10)};
+    expected = {queue[1], queue[0]};
+    statistics.queueDepth = 3;
+    statistics.queuedBytes = 1810;
+
+    selected = s3dl::UploadScheduler::selectUploads(queue, 10, 1000, statistics);
+    check(selected == expected, "scheduler: due uploads ignore the frame budget");
+    check(queue.size() == 1 && queue[0]->getPriority() == 9, "scheduler: due uploads use up the frame budget");
+    check(statistics.missedDeadlines == 1, "scheduler: missed deadlines are counted");
+}
+
+void testMipChain()
+{
+    // 2x2 box filter, rounded to nearest
+
+    const unsigned char pixels[16] = {10, 0, 255, 1, 20, 0, 255, 2, 30, 0, 255, 2, 41, 1, 255, 2};
+    std::vector<s3dl::TextureData> mipChain = s3dl::TextureStreamer::generateMipChain(s3dl::TextureData(2, 2, pixels), 2);
+
+    check(mipChain.size() == 2 && mipChain[1].size().x == 1 && mipChain[1].size().y == 1, "mip chain: 2x2 texture has a 1x1 level");
+    check(isTexel(mipChain[0], 1, 1, {41, 1, 255, 2}), "mip chain: first level is the texture itself");
+    check(isTexel(mipChain[1], 0, 0, {25, 0, 255, 2}), "mip chain: texels are averaged and rounded");
+
+    // Non square and odd sizes, the last row or column is repeated
+
+    mipChain = s3dl::TextureStreamer::generateMipChain(s3dl::TextureData(4, 2), 3);
+    check(mipChain.size() == 3 && mipChain[1].size().x == 2 && mipChain[1].size().y == 1, "mip chain: 4x2 texture has a 2x1 level");
+    check(mipChain[2].size().x == 1 && mipChain[2].size().y == 1, "mip chain: 4x2 texture ends with a 1x1 level");
+
+    const unsigned char column[8] = {10, 0, 0, 255, 21, 0, 0, 255};
+    mipChain = s3dl::TextureStreamer::generateMipChain(s3dl::TextureData(1, 2, column), 2);
+    check(isTexel(mipChain[1], 0, 0, {16, 0, 0, 255}), "mip chain: single column is filtered vertically only");
+}
+
+void testCompressedTextureData()
+{
+    // BC1 endpoints red and blue, texels 0 to 3 use each palette entry
+
+    s3dl::TextureData textureData = decodeBlocks(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 4, 4, {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00});
+    check(isTexel(textureData, 0, 0, {255, 0, 0, 255}), "BC1: first endpoint");
+    check(isTexel(textureData, 1, 0, {0, 0, 255, 255}), "BC1: second endpoint");
+    check(isTexel(textureData, 2, 0, {170, 0, 85, 255}), "BC1: first interpolated color");
+    check(isTexel(textureData, 3, 0, {85, 0, 170, 255}), "BC1: second interpolated color");
+    check(isTexel(textureData, 3, 3, {255, 0, 0, 255}), "BC1: last texel");
+
+    // BC3 alpha interpolated between 255 and 0, color block solid red
+
+    textureData = decodeBlocks(VK_FORMAT_BC3_UNORM_BLOCK, 4, 4, {0xFF, 0x00, 0x88, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00});
+    check(isTexel(textureData, 0, 0, {255, 0, 0, 255}), "BC3: first alpha endpoint");
+    check(isTexel(textureData, 1, 0, {255, 0, 0, 0}), "BC3: second alpha endpoint");
+    check(isTexel(textureData, 2, 0, {255, 0, 0, 219}), "BC3: first interpolated alpha");
+    check(isTexel(textureData, 3, 0, {255, 0, 0, 36}), "BC3: last interpolated alpha");
+
+    // BC4 and BC5 solid blocks, missing channels read as 0 and alpha as opaque
+
+    textureData = decodeBlocks(VK_FORMAT_BC4_UNORM_BLOCK, 4, 4, {200, 200, 0, 0, 0, 0, 0, 0});
+    check(isTexel(textureData, 2, 1, {200, 0, 0, 255}), "BC4: single channel");
+
+    textureData = decodeBlocks(VK_FORMAT_BC5_UNORM_BLOCK, 4, 4, {200, 200, 0, 0, 0, 0, 0, 0, 100, 100, 0, 0, 0, 0, 0, 0});
+    check(isTexel(textureData, 1, 2, {200, 100, 0, 255}), "BC5: two channels");
+
+    // ETC2 individual mode with identical subblocks, EAC alpha with a single modifier
+
+    textureData = decodeBlocks(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, 4, 4, {0xFF, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00});
+    check(isTexel(textureData, 0, 0, {255, 2, 138, 255}), "ETC2: individual mode");
+    check(isTexel(textureData, 3, 3, {255, 2, 138, 255}), "ETC2: individual mode last texel");
+
+    textureData = decodeBlocks(VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, 4, 4, {128, 0x10, 0, 0, 0, 0, 0, 0, 0xFF, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00});
+    check(isTexel(textureData, 1, 1, {255, 2, 138, 125}), "ETC2: EAC alpha");
+
+    // Blocks hanging over the edges of the image are cropped
+
+    textureData = decodeBlocks(VK_FORMAT_BC4_UNORM_BLOCK, 6, 2, {10, 10, 0, 0, 0, 0, 0, 0, 20, 20, 0, 0, 0, 0, 0, 0});
+    check(textureData.size().x == 6 && textureData.size().y == 2, "decoder: size of a partial block image");
+    check(isTexel(textureData, 3, 1, {10, 0, 0, 255}) && isTexel(textureData, 5, 1, {20, 0, 0, 255}), "decoder: partial blocks");
+}
+
+void testReferenceBlocks()
+{
+    // Known answers, the blocks are packed by hand from the bit layouts of the Khronos Data Format and Direct3D
+    // specifications and the texels computed from their formulas, interpolations rounded to nearest
+
+    // ETC2 individual mode
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0xA2, 0x3C, 0x6F, 0x38, 0x59, 0xC6, 0x7A, 0x9A}, {
+        175,  56, 107, 255, 187,  68, 119, 255,   1, 171, 222, 255,   0,  98, 149, 255,
+        153,  34,  85, 255, 175,  56, 107, 255, 140, 255, 255, 255, 140, 255, 255, 255,
+        165,  46,  97, 255, 165,  46,  97, 255,  67, 237, 255, 255,   0,  98, 149, 255,
+        187,  68, 119, 255, 153,  34,  85, 255,   0,  98, 149, 255,  67, 237, 255, 255
+    }, "ETC2: individual mode, side by side subblocks");
+
+    // ETC2 differential mode
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0xA5, 0x2A, 0xE3, 0x63, 0x59, 0xC6, 0x7A, 0x9A}, {
+        178,  54, 244, 255, 207,  83, 255, 255, 152,  28, 218, 255, 123,   0, 189, 255,
+        123,   0, 189, 255, 178,  54, 244, 255, 207,  83, 255, 255, 207,  83, 255, 255,
+        138,  55, 253, 255, 138,  55, 253, 255, 142,  59, 255, 255, 132,  49, 247, 255,
+        148,  65, 255, 255, 132,  49, 247, 255, 132,  49, 247, 255, 142,  59, 255, 255
+    }, "ETC2: differential mode, stacked subblocks, clamping");
+
+    // ETC2 T mode
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0x1C, 0x49, 0x38, 0xEB, 0x59, 0xC6, 0x7A, 0x9A}, {
+        204,  68, 153, 255,  83, 168, 255, 255,  51, 136, 238, 255,  19, 104, 206, 255,
+         19, 104, 206, 255, 204,  68, 153, 255,  83, 168, 255, 255,  83, 168, 255, 255,
+         51, 136, 238, 255,  51, 136, 238, 255, 204,  68, 153, 255,  19, 104, 206, 255,
+         83, 168, 255, 255,  19, 104, 206, 255,  19, 104, 206, 255, 204,  68, 153, 255
+    }, "ETC2: T mode");
+
+    // ETC2 H mode
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0x95, 0xF2, 0xC8, 0xE6, 0x59, 0xC6, 0x7A, 0x9A}, {
+         57, 210, 108, 255,  11, 164,  62, 255, 176,  40, 227, 255, 130,   0, 181, 255,
+        130,   0, 181, 255,  57, 210, 108, 255,  11, 164,  62, 255,  11, 164,  62, 255,
+        176,  40, 227, 255, 176,  40, 227, 255,  57, 210, 108, 255, 130,   0, 181, 255,
+         11, 164,  62, 255, 130,   0, 181, 255, 130,   0, 181, 255,  57, 210, 108, 255
+    }, "ETC2: H mode, first color below the second");
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0x73, 0x05, 0xA5, 0x0B, 0x59, 0xC6, 0x7A, 0x9A}, {
+        254, 118,  67, 255, 222,  86,  35, 255,  84, 186,  33, 255,  52, 154,   1, 255,
+         52, 154,   1, 255, 254, 118,  67, 255, 222,  86,  35, 255, 222,  86,  35, 255,
+         84, 186,  33, 255,  84, 186,  33, 255, 254, 118,  67, 255,  52, 154,   1, 255,
+        222,  86,  35, 255,  52, 154,   1, 255,  52, 154,   1, 255, 254, 118,  67, 255
+    }, "ETC2: H mode, first color above the second");
+
+    // ETC2 planar mode
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {0x95, 0x49, 0x15, 0x7A, 0x28, 0x2C, 0x3F, 0xFF}, {
+         40, 201, 203, 255,  91, 161, 157, 255, 142, 121, 112, 255, 192,  80,  66, 255,
+         64, 215, 216, 255, 114, 174, 170, 255, 165, 134, 125, 255, 216,  94,  79, 255,
+         87, 228, 229, 255, 138, 188, 183, 255, 189, 148, 138, 255, 239, 107,  92, 255,
+        111, 242, 242, 255, 161, 201, 196, 255, 212, 161, 151, 255, 255, 121, 105, 255
+    }, "ETC2: planar mode");
+
+    // EAC alpha
+
+    checkBlock(VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, {0x64, 0x7B, 0x13, 0xD3, 0x59, 0x5B, 0x47, 0xD0, 0xA2, 0x3C, 0x6F, 0x38, 0x59, 0xC6, 0x7A, 0x9A}, {
+        175,  56, 107,  86, 187,  68, 119,  65,   1, 171, 222,  51,   0,  98, 149,  30,
+        153,  34,  85, 107, 175,  56, 107, 128, 140, 255, 255, 142, 140, 255, 255, 163,
+        165,  46,  97, 163, 165,  46,  97,  30,  67, 237, 255, 142,   0,  98, 149,  51,
+        187,  68, 119, 128, 153,  34,  85,  65,   0,  98, 149, 107,  67, 237, 255,  86
+    }, "ETC2: EAC alpha, every modifier");
+    checkBlock(VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, {0xFA, 0xF0, 0x13, 0xD3, 0x59, 0x5B, 0x47, 0xD0, 0xA2, 0x3C, 0x6F, 0x38, 0x59, 0xC6, 0x7A, 0x9A}, {
+        175,  56, 107, 205, 187,  68, 119, 160,   1, 171, 222, 115,   0,  98, 149,  25,
+        153,  34,  85, 255, 175,  56, 107, 255, 140, 255, 255, 255, 140, 255, 255, 255,
+        165,  46,  97, 255, 165,  46,  97,  25,  67, 237, 255, 255,   0,  98, 149, 115,
+        187,  68, 119, 255, 153,  34,  85, 160,   0,  98, 149, 255,  67, 237, 255, 205
+    }, "ETC2: EAC alpha clamping");
+
+    // BC1 four color and three color modes
+
+    checkBlock(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, {0x07, 0xCD, 0x9E, 0x19, 0xE4, 0x53, 0xCA, 0x3D}, {
+        206, 162,  57, 255,  24,  48, 247, 255, 145, 124, 120, 255,  85,  86, 184, 255,
+         85,  86, 184, 255, 206, 162,  57, 255,  24,  48, 247, 255,  24,  48, 247, 255,
+        145, 124, 120, 255, 145, 124, 120, 255, 206, 162,  57, 255,  85,  86, 184, 255,
+         24,  48, 247, 255,  85,  86, 184, 255,  85,  86, 184, 255, 206, 162,  57, 255
+    }, "BC1: four color mode");
+    checkBlock(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, {0x9E, 0x19, 0x08, 0xCD, 0xE4, 0x53, 0xCA, 0x3D}, {
+         24,  48, 247, 255, 206, 162,  66, 255, 115, 105, 157, 255,   0,   0,   0,   0,
+          0,   0,   0,   0,  24,  48, 247, 255, 206, 162,  66, 255, 206, 162,  66, 255,
+        115, 105, 157, 255, 115, 105, 157, 255,  24,  48, 247, 255,   0,   0,   0,   0,
+        206, 162,  66, 255,   0,   0,   0,   0,   0,   0,   0,   0,  24,  48, 247, 255
+    }, "BC1: three color mode, transparent black");
+    checkBlock(VK_FORMAT_BC1_RGB_UNORM_BLOCK, {0x9E, 0x19, 0x08, 0xCD, 0xE4, 0x53, 0xCA, 0x3D}, {
+         24,  48, 247, 255, 206, 162,  66, 255, 115, 105, 157, 255,   0,   0,   0, 255,
+          0,   0,   0, 255,  24,  48, 247, 255, 206, 162,  66, 255, 206, 162,  66, 255,
+        115, 105, 157, 255, 115, 105, 157, 255,  24,  48, 247, 255,   0,   0,   0, 255,
+        206, 162,  66, 255,   0,   0,   0, 255,   0,   0,   0, 255,  24,  48, 247, 255
+    }, "BC1: three color mode without alpha, opaque black");
+
+    // BC3 color block always in four color mode
+
+    checkBlock(VK_FORMAT_BC3_UNORM_BLOCK, {0x28, 0xD2, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05, 0x9E, 0x19, 0x07, 0xCD, 0xE4, 0x53, 0xCA, 0x3D}, {
+         24,  48, 247,  40, 206, 162,  57, 210,  85,  86, 184,  74, 145, 124, 120, 108,
+        145, 124, 120, 142,  24,  48, 247, 176, 206, 162,  57,   0, 206, 162,  57, 255,
+         85,  86, 184, 255,  85,  86, 184,   0,  24,  48, 247, 176, 145, 124, 120, 142,
+        206, 162,  57, 108, 145, 124, 120,  74, 145, 124, 120, 210,  24,  48, 247,  40
+    }, "BC3: alpha in six value mode, color in four color mode");
+
+    // BC4 eight and six value modes
+
+    checkBlock(VK_FORMAT_BC4_UNORM_BLOCK, {0xE6, 0x11, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05}, {
+        230,   0,   0, 255,  17,   0,   0, 255, 200,   0,   0, 255, 169,   0,   0, 255,
+        139,   0,   0, 255, 108,   0,   0, 255,  78,   0,   0, 255,  47,   0,   0, 255,
+         47,   0,   0, 255,  78,   0,   0, 255, 108,   0,   0, 255, 139,   0,   0, 255,
+        169,   0,   0, 255, 200,   0,   0, 255,  17,   0,   0, 255, 230,   0,   0, 255
+    }, "BC4: eight value mode");
+    checkBlock(VK_FORMAT_BC4_UNORM_BLOCK, {0x28, 0xD2, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05}, {
+         40,   0,   0, 255, 210,   0,   0, 255,  74,   0,   0, 255, 108,   0,   0, 255,
+        142,   0,   0, 255, 176,   0,   0, 255,   0,   0,   0, 255, 255,   0,   0, 255,
+        255,   0,   0, 255,   0,   0,   0, 255, 176,   0,   0, 255, 142,   0,   0, 255,
+        108,   0,   0, 255,  74,   0,   0, 255, 210,   0,   0, 255,  40,   0,   0, 255
+    }, "BC4: six value mode, 0 and 255");
+
+    // BC5 one mode per channel
+
+    checkBlock(VK_FORMAT_BC5_UNORM_BLOCK, {0xE6, 0x11, 0x88, 0xC6, 0xFA, 0x77, 0x39, 0x05, 0x28, 0xD2, 0x88, 0x36, 0x24, 0x12, 0x96, 0x0D}, {
+        230,  40,   0, 255,  17, 210,   0, 255, 200,  74,   0, 255, 169, 108,   0, 255,
+        139, 108,   0, 255, 108,  40,   0, 255,  78, 210,   0, 255,  47, 210,   0, 255,
+         47,  74,   0, 255,  78,  74,   0, 255, 108,  40,   0, 255, 139, 108,   0, 255,
+        169, 210,   0, 255, 200, 108,   0, 255,  17, 108,   0, 255, 230,  40,   0, 255
+    }, "BC5: two channels");
+}
 
 int main()
 {
-	std::cout << "Best test ever." << std::endl;
+    testMemoryAllocator();
+    testStagingBufferPool();
+    testUploadScheduler();
+    testMipChain();
+    testCompressedTextureData();
+    testReferenceBlocks();
 
-	system("pause");
+    if (failureCount != 0)
+    {
+        std::cout << failureCount << " test(s) failed." << std::endl;
+        return 1;
+    }
 
-	return 0;
+    std::cout << "All tests passed." << std::endl;
+    return 0;
 }